@@ -0,0 +1,162 @@
+// Only this translation unit asks glm for intrinsics, so the rest of the build
+// keeps its current glm configuration
+#define GLM_FORCE_INTRINSICS
+#include "glm/simd/platform.h"
+#include <cmath>
+#include "AabbBatch.h"
+
+void aabb_batch_clear_lane(AabbBatch& batch, int lane)
+{
+    batch.x[lane] = 0.0f;
+    batch.y[lane] = 0.0f;
+    batch.half_width[lane]  = -INFINITY;
+    batch.half_height[lane] = -INFINITY;
+}
+
+static unsigned int overlap_batch_scalar(float query_x, float query_y,
+                                         float query_half_width, float query_half_height,
+                                         const float* x, const float* y, const float* half_width, const float* half_height,
+                                         float* overlap_x, float* overlap_y)
+{
+    unsigned int mask = 0;
+
+    for (int lane = 0; lane < AABB_BATCH_WIDTH; lane++)
+    {
+        overlap_x[lane] = (query_half_width  + half_width[lane])  - fabsf(query_x - x[lane]);
+        overlap_y[lane] = (query_half_height + half_height[lane]) - fabsf(query_y - y[lane]);
+
+        if (overlap_x[lane] > 0.0f && overlap_y[lane] > 0.0f) { mask |= 1u << lane; }
+    }
+
+    return mask;
+}
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+static unsigned int overlap_batch_sse2(float query_x, float query_y,
+                                       float query_half_width, float query_half_height,
+                                       const float* x, const float* y, const float* half_width, const float* half_height,
+                                       float* overlap_x, float* overlap_y)
+{
+    const __m128 sign_mask = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 qx  = _mm_set1_ps(query_x);
+    const __m128 qy  = _mm_set1_ps(query_y);
+    const __m128 qhw = _mm_set1_ps(query_half_width);
+    const __m128 qhh = _mm_set1_ps(query_half_height);
+
+    unsigned int mask = 0;
+
+    // Two 4-wide halves per batch
+    for (int lane = 0; lane < AABB_BATCH_WIDTH; lane += 4)
+    {
+        __m128 x_distance = _mm_andnot_ps(sign_mask, _mm_sub_ps(qx, _mm_loadu_ps(x + lane)));
+        __m128 y_distance = _mm_andnot_ps(sign_mask, _mm_sub_ps(qy, _mm_loadu_ps(y + lane)));
+
+        __m128 x_overlap = _mm_sub_ps(_mm_add_ps(qhw, _mm_loadu_ps(half_width + lane)), x_distance);
+        __m128 y_overlap = _mm_sub_ps(_mm_add_ps(qhh, _mm_loadu_ps(half_height + lane)), y_distance);
+
+        _mm_storeu_ps(overlap_x + lane, x_overlap);
+        _mm_storeu_ps(overlap_y + lane, y_overlap);
+
+        __m128 hit = _mm_and_ps(_mm_cmpgt_ps(x_overlap, zero), _mm_cmpgt_ps(y_overlap, zero));
+        mask |= (unsigned int) _mm_movemask_ps(hit) << lane;
+    }
+
+    return mask;
+}
+
+#endif
+
+#if GLM_ARCH & GLM_ARCH_AVX_BIT
+
+static unsigned int overlap_batch_avx(float query_x, float query_y,
+                                      float query_half_width, float query_half_height,
+                                      const float* x, const float* y, const float* half_width, const float* half_height,
+                                      float* overlap_x, float* overlap_y)
+{
+    const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+    const __m256 zero = _mm256_setzero_ps();
+
+    __m256 x_distance = _mm256_andnot_ps(sign_mask, _mm256_sub_ps(_mm256_set1_ps(query_x), _mm256_loadu_ps(x)));
+    __m256 y_distance = _mm256_andnot_ps(sign_mask, _mm256_sub_ps(_mm256_set1_ps(query_y), _mm256_loadu_ps(y)));
+
+    __m256 x_overlap = _mm256_sub_ps(_mm256_add_ps(_mm256_set1_ps(query_half_width), _mm256_loadu_ps(half_width)), x_distance);
+    __m256 y_overlap = _mm256_sub_ps(_mm256_add_ps(_mm256_set1_ps(query_half_height), _mm256_loadu_ps(half_height)), y_distance);
+
+    _mm256_storeu_ps(overlap_x, x_overlap);
+    _mm256_storeu_ps(overlap_y, y_overlap);
+
+    __m256 hit = _mm256_and_ps(_mm256_cmp_ps(x_overlap, zero, _CMP_GT_OQ), _mm256_cmp_ps(y_overlap, zero, _CMP_GT_OQ));
+    return (unsigned int) _mm256_movemask_ps(hit);
+}
+
+#endif
+
+unsigned int const aabb_overlap_arrays(float query_x, float query_y,
+                                       float query_half_width, float query_half_height,
+                                       const float* x, const float* y, const float* half_width, const float* half_height,
+                                       float* overlap_x, float* overlap_y)
+{
+#if GLM_ARCH & GLM_ARCH_AVX_BIT
+    return overlap_batch_avx(query_x, query_y, query_half_width, query_half_height, x, y, half_width, half_height, overlap_x, overlap_y);
+#elif GLM_ARCH & GLM_ARCH_SSE2_BIT
+    return overlap_batch_sse2(query_x, query_y, query_half_width, query_half_height, x, y, half_width, half_height, overlap_x, overlap_y);
+#else
+    return overlap_batch_scalar(query_x, query_y, query_half_width, query_half_height, x, y, half_width, half_height, overlap_x, overlap_y);
+#endif
+}
+
+unsigned int const aabb_overlap_batch(float query_x, float query_y,
+                                      float query_half_width, float query_half_height,
+                                      const AabbBatch& batch,
+                                      float* overlap_x, float* overlap_y)
+{
+    return aabb_overlap_arrays(query_x, query_y, query_half_width, query_half_height,
+                               batch.x, batch.y, batch.half_width, batch.half_height, overlap_x, overlap_y);
+}
+
+bool const aabb_backend_available(AabbBackend backend)
+{
+    switch (backend)
+    {
+    case AABB_SCALAR: return true;
+    case AABB_SSE2:   return (GLM_ARCH & GLM_ARCH_SSE2_BIT) != 0;
+    case AABB_AVX:    return (GLM_ARCH & GLM_ARCH_AVX_BIT) != 0;
+    }
+    return false;
+}
+
+const char* const aabb_backend_name(AabbBackend backend)
+{
+    switch (backend)
+    {
+    case AABB_SCALAR: return "scalar";
+    case AABB_SSE2:   return "SSE2";
+    case AABB_AVX:    return "AVX";
+    }
+    return "unknown";
+}
+
+unsigned int const aabb_overlap_batch_on(AabbBackend backend,
+                                         float query_x, float query_y,
+                                         float query_half_width, float query_half_height,
+                                         const AabbBatch& batch,
+                                         float* overlap_x, float* overlap_y)
+{
+    const float* x = batch.x;
+    const float* y = batch.y;
+    const float* half_width = batch.half_width;
+    const float* half_height = batch.half_height;
+
+    switch (backend)
+    {
+#if GLM_ARCH & GLM_ARCH_AVX_BIT
+    case AABB_AVX:  return overlap_batch_avx(query_x, query_y, query_half_width, query_half_height, x, y, half_width, half_height, overlap_x, overlap_y);
+#endif
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    case AABB_SSE2: return overlap_batch_sse2(query_x, query_y, query_half_width, query_half_height, x, y, half_width, half_height, overlap_x, overlap_y);
+#endif
+    default:        return overlap_batch_scalar(query_x, query_y, query_half_width, query_half_height, x, y, half_width, half_height, overlap_x, overlap_y);
+    }
+}
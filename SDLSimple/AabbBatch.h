@@ -0,0 +1,53 @@
+#ifndef AABB_BATCH_H
+#define AABB_BATCH_H
+
+/**
+ * Batched AABB overlap test: one query box against AABB_BATCH_WIDTH candidate
+ * boxes at a time. The backend (AVX, SSE2 or plain scalar) is picked at compile
+ * time from glm's simd platform detection; define GLM_FORCE_PURE to force the
+ * scalar path.
+ */
+constexpr int AABB_BATCH_WIDTH = 8;
+
+struct AabbBatch
+{
+    alignas(32) float x[AABB_BATCH_WIDTH];
+    alignas(32) float y[AABB_BATCH_WIDTH];
+    alignas(32) float half_width[AABB_BATCH_WIDTH];
+    alignas(32) float half_height[AABB_BATCH_WIDTH];
+};
+
+// Fills lane `lane` with a box that can never overlap anything (negative extents)
+void aabb_batch_clear_lane(AabbBatch& batch, int lane);
+
+// Returns a bitmask with bit i set when candidate i overlaps the query box.
+// overlap_x / overlap_y receive (sum of half extents) - |centre distance| per
+// lane, i.e. the penetration depth on each axis when the lane is a hit.
+unsigned int const aabb_overlap_batch(float query_x, float query_y,
+                                      float query_half_width, float query_half_height,
+                                      const AabbBatch& batch,
+                                      float* overlap_x, float* overlap_y);
+
+// The same test straight from AABB_BATCH_WIDTH consecutive entries of structure-of-arrays
+// storage (EntityPool's), with no copy into an AabbBatch; the arrays need no alignment
+unsigned int const aabb_overlap_arrays(float query_x, float query_y,
+                                       float query_half_width, float query_half_height,
+                                       const float* x, const float* y, const float* half_width, const float* half_height,
+                                       float* overlap_x, float* overlap_y);
+
+// ————— BACKENDS ————— //
+// Every backend this build compiled, so a check can hold the vector paths
+// against the scalar one. aabb_overlap_batch above always uses the widest.
+enum AabbBackend { AABB_SCALAR, AABB_SSE2, AABB_AVX };
+
+bool const aabb_backend_available(AabbBackend backend);
+const char* const aabb_backend_name(AabbBackend backend);
+
+// aabb_overlap_batch on a given backend; the backend must be available
+unsigned int const aabb_overlap_batch_on(AabbBackend backend,
+                                         float query_x, float query_y,
+                                         float query_half_width, float query_half_height,
+                                         const AabbBatch& batch,
+                                         float* overlap_x, float* overlap_y);
+
+#endif // AABB_BATCH_H
@@ -0,0 +1,41 @@
+#include "BatchRunner.h"
+#include "Profiler.h"
+
+constexpr int EPISODES_PER_TASK = 64;
+
+void run_episodes(ThreadPool& pool, unsigned long long base_seed, int episode_count, int max_frames,
+                  const std::vector<unsigned char>& script, EpisodeResult* results,
+                  float delta_time, CollisionMode collision_mode)
+{
+    pool.parallel_for(episode_count, EPISODES_PER_TASK, [&](int begin, int end)
+    {
+        GameState state;
+        state.collision_mode = collision_mode;
+
+        for (int episode = begin; episode < end; episode++)
+        {
+            PROFILE_ZONE("episode");
+            EpisodeResult& result = results[episode];
+            result.seed = base_seed + episode;
+
+            randomise_game_state(state, result.seed);
+            result.target_index = state.target_index;
+            result.start_x = state.player.get_position().x;
+            result.gravity = state.gravity;
+            result.outcome = NOCOLLISION;
+
+            int frame = 0;
+            while (!state.game_over && frame < max_frames)
+            {
+                apply_input(state, frame < (int) script.size() ? script[frame] : 0);
+                CollisionType collision = step_game_state(state, delta_time);
+                frame++;
+
+                if (collision != NOCOLLISION) { result.outcome = collision; }
+            }
+
+            result.frames = frame;
+            result.time_to_touchdown = frame * delta_time;
+        }
+    });
+}
@@ -0,0 +1,31 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <vector>
+#include "GameState.h"
+#include "ThreadPool.h"
+
+struct EpisodeResult
+{
+    unsigned long long seed;
+    int   target_index;
+    float start_x;
+    float gravity;
+
+    CollisionType outcome;      // NOCOLLISION when the episode timed out
+    int   frames;
+    float time_to_touchdown;    // seconds of simulated time
+};
+
+/**
+ * Runs `episode_count` independent episodes, seeded base_seed + i, across the
+ * pool. Each task owns one GameState and reuses it for EPISODES_PER_TASK
+ * episodes, so workers share nothing but the read-only script and write
+ * disjoint slots of `results`. A larger `delta_time` trades accuracy for
+ * throughput; pair it with SWEPT collisions so landers cannot tunnel.
+ */
+void run_episodes(ThreadPool& pool, unsigned long long base_seed, int episode_count, int max_frames,
+                  const std::vector<unsigned char>& script, EpisodeResult* results,
+                  float delta_time = FIXED_TIMESTEP, CollisionMode collision_mode = DISCRETE);
+
+#endif // BATCH_RUNNER_H
@@ -0,0 +1,652 @@
+#define LOG(argument) std::cout << argument << '\n'
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Entity.h"
+#include "EntityPool.h"
+#include "UniformGrid.h"
+#include "StaticBvh.h"
+#include "SweepAndPrune.h"
+#include "Integrator.h"
+#include "ImageDecodeQueue.h"
+#include "TexturePack.h"
+#include "GameState.h"
+#include "SnapshotRing.h"
+#include "LanderVecEnv.h"
+#include "FramePacer.h"
+#include "Benchmarks.h"
+
+using benchmark_clock = std::chrono::steady_clock;
+
+static double const seconds_since(benchmark_clock::time_point start)
+{
+    return std::chrono::duration<double>(benchmark_clock::now() - start).count();
+}
+
+// Lays `count` 1x1 platforms out on a square lattice with a one-tile gap
+static int const build_platform_field(EntityPool& pool, int count)
+{
+    int side = (int) ceil(sqrt((double) count));
+
+    pool.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        pool[i].set_position(glm::vec3((i % side) * 2.0f - side, (i / side) * 2.0f - side, 0.0f));
+        pool[i].set_platform_type(i % 7 == 0 ? TRAP : NORMAL);
+    }
+
+    return side;
+}
+
+// Order-independent digest of the platforms a resolve_collisions touched, for comparing broadphases
+static long long const contact_checksum(const Entity& lander)
+{
+    long long checksum = 0;
+    for (int i = 0; i < lander.get_contact_count(); i++) { checksum += lander.get_contacts()[i].index + 1; }
+    return checksum;
+}
+
+static Entity const make_probe()
+{
+    Entity probe;
+    probe.set_width(0.9f);
+    probe.set_height(0.9f);
+    probe.set_velocity(glm::vec3(0.0f, -1.0f, 0.0f));
+    return probe;
+}
+
+bool run_broadphase_benchmark()
+{
+    const int PLATFORM_COUNTS[] = { 10, 1000, 100000, 1000000 };
+    const int GRID_QUERIES = 200000;
+    const long long LINEAR_BUDGET = 200000000;  // platform tests per linear run
+
+    LOG("platforms    grid build (ms)    bvh build (ms)    linear (ns/query)    grid (ns/query)    bvh (ns/query)    bvh ray (ns)"
+        "    contact checksum    ray hits");
+
+    for (int platform_count : PLATFORM_COUNTS)
+    {
+        EntityPool pool;
+        int side = build_platform_field(pool, platform_count);
+
+        auto start = benchmark_clock::now();
+        UniformGrid grid;
+        for (int i = 0; i < platform_count; i++)
+        {
+            grid.insert(i, pool[i].get_position(), pool[i].get_width(), pool[i].get_height());
+        }
+        double build_seconds = seconds_since(start);
+
+        start = benchmark_clock::now();
+        StaticBvh bvh;
+        bvh.build(pool.get_x(), pool.get_y(), pool.get_half_width(), pool.get_half_height(), platform_count);
+        double bvh_build_seconds = seconds_since(start);
+
+        // Same random query points for both runs
+        int linear_queries = (int) std::max(20LL, LINEAR_BUDGET / platform_count);
+        std::vector<glm::vec3> queries(GRID_QUERIES);
+        srand(1);
+        for (glm::vec3& query : queries)
+        {
+            query = glm::vec3((rand() / (float) RAND_MAX) * 2.0f * side - side,
+                              (rand() / (float) RAND_MAX) * 2.0f * side - side, 0.0f);
+        }
+
+        // Linear runs wrap around the query list; all three broadphases are compared over the queries they share
+        int shared_queries = std::min(linear_queries, GRID_QUERIES);
+        Entity probe = make_probe();
+
+        start = benchmark_clock::now();
+        long long linear_checksum = 0, linear_shared = 0;
+        for (int q = 0; q < linear_queries; q++)
+        {
+            Entity lander = probe;
+            lander.set_position(queries[q % GRID_QUERIES]);
+            lander.resolve_collisions(&pool);
+            linear_checksum += contact_checksum(lander);
+            if (q + 1 == shared_queries) { linear_shared = linear_checksum; }
+        }
+        double linear_ns = seconds_since(start) * 1e9 / linear_queries;
+
+        start = benchmark_clock::now();
+        long long grid_checksum = 0, grid_shared = 0;
+        for (int q = 0; q < GRID_QUERIES; q++)
+        {
+            Entity lander = probe;
+            lander.set_position(queries[q]);
+            lander.resolve_collisions(&pool, &grid);
+            grid_checksum += contact_checksum(lander);
+            if (q + 1 == shared_queries) { grid_shared = grid_checksum; }
+        }
+        double grid_ns = seconds_since(start) * 1e9 / GRID_QUERIES;
+
+        start = benchmark_clock::now();
+        long long bvh_checksum = 0;
+        for (int q = 0; q < GRID_QUERIES; q++)
+        {
+            Entity lander = probe;
+            lander.set_position(queries[q]);
+            lander.resolve_collisions(&pool, &bvh);
+            bvh_checksum += contact_checksum(lander);
+        }
+        double bvh_ns = seconds_since(start) * 1e9 / GRID_QUERIES;
+
+        if (linear_shared != grid_shared || bvh_checksum != grid_checksum)
+        {
+            LOG("Mismatch at " << platform_count << " platforms: linear " << linear_shared << ", grid " << grid_shared
+                << " over " << shared_queries << " queries; grid " << grid_checksum << ", bvh " << bvh_checksum
+                << " over " << GRID_QUERIES);
+            return false;
+        }
+
+        // Altitude probes: straight down from each query point
+        start = benchmark_clock::now();
+        RayHit hit;
+        int ray_hits = 0;
+        for (int q = 0; q < GRID_QUERIES; q++)
+        {
+            ray_hits += bvh.raycast(queries[q], glm::vec3(0.0f, -1.0f, 0.0f), ALTITUDE_RAY_LENGTH, &hit);
+        }
+        double ray_ns = seconds_since(start) * 1e9 / GRID_QUERIES;
+
+        LOG(platform_count << "\t\t" << build_seconds * 1e3 << "\t\t" << bvh_build_seconds * 1e3 << "\t\t"
+            << linear_ns << "\t\t" << grid_ns << "\t\t" << bvh_ns << "\t\t" << ray_ns << "\t\t" << grid_checksum
+            << "\t\t" << ray_hits);
+    }
+    return true;
+}
+
+void run_pool_benchmark()
+{
+    const int PLATFORM_COUNT = 1000000;
+    const int PASSES = 50;
+
+    EntityPool pool;
+    build_platform_field(pool, PLATFORM_COUNT);
+
+    std::vector<Entity> platforms(PLATFORM_COUNT);
+    for (int i = 0; i < PLATFORM_COUNT; i++)
+    {
+        platforms[i].set_position(pool[i].get_position());
+        platforms[i].set_platform_type(pool[i].get_platform_type());
+    }
+
+    // A probe that sits in a lattice gap touches nothing, so every pass is a full scan
+    Entity probe = make_probe();
+    probe.set_position(glm::vec3(1.0f, 1.0f, 0.0f));
+    int hits = 0;
+
+    auto start = benchmark_clock::now();
+    for (int pass = 0; pass < PASSES; pass++)
+    {
+        for (int i = 0; i < PLATFORM_COUNT; i++) { hits += probe.check_collision(&platforms[i]); }
+    }
+    double aos_ns = seconds_since(start) * 1e9 / ((double) PASSES * PLATFORM_COUNT);
+
+    start = benchmark_clock::now();
+    for (int pass = 0; pass < PASSES; pass++)
+    {
+        for (int i = 0; i < PLATFORM_COUNT; i++) { hits += probe.check_collision(&pool, i); }
+    }
+    double soa_ns = seconds_since(start) * 1e9 / ((double) PASSES * PLATFORM_COUNT);
+
+    start = benchmark_clock::now();
+    for (int pass = 0; pass < PASSES; pass++)
+    {
+        Entity lander = probe;
+        hits += lander.resolve_collisions(&pool) != NOCOLLISION;
+    }
+    double batched_ns = seconds_since(start) * 1e9 / ((double) PASSES * PLATFORM_COUNT);
+
+    // Static sizes, not measurements: how far apart consecutive platforms sit in memory and
+    // how much a full scan has to pull through the caches. Cache misses are not counted.
+    int soa_bytes = 4 * sizeof(float) + sizeof(unsigned char);
+    double aos_mb = (double) sizeof(Entity) * PLATFORM_COUNT / (1024.0 * 1024.0);
+    double soa_mb = (double) soa_bytes * PLATFORM_COUNT / (1024.0 * 1024.0);
+
+    LOG(PLATFORM_COUNT << " platforms, " << PASSES << " full scans; footprint is static layout size, not a measured miss count");
+    LOG("Entity array:       " << aos_ns << " ns/platform (" << 1e3 / aos_ns << " M/s), "
+        << sizeof(Entity) << " bytes/platform footprint, " << aos_mb << " MB working set");
+    LOG("EntityPool scalar:  " << soa_ns << " ns/platform (" << 1e3 / soa_ns << " M/s), "
+        << soa_bytes << " bytes/platform footprint, " << soa_mb << " MB working set");
+    LOG("EntityPool batched: " << batched_ns << " ns/platform (" << 1e3 / batched_ns << " M/s), "
+        << soa_bytes << " bytes/platform footprint, " << soa_mb << " MB working set");
+    LOG("speedup (batched vs Entity array): " << aos_ns / batched_ns << "x");
+    LOG("speedup (batched vs pool scalar):  " << soa_ns / batched_ns << "x");
+    LOG("probe overlaps:     " << hits << " (0 expected: the probe sits in a gap)");
+}
+
+// One byte per 4 KiB page of an RGBA8 image
+static unsigned long long const sample_texels(const unsigned char* texels, uint64_t bytes)
+{
+    unsigned long long sum = 0;
+    for (uint64_t byte = 0; byte < bytes; byte += 4096) { sum += texels[byte]; }
+    return sum;
+}
+
+bool run_texture_decode_benchmark()
+{
+    // The five shipped assets, repeated to stand in for a production-sized sprite set
+    const char* const assets[] = { "assets/platform.png", "assets/wintile.png", "assets/player.png",
+                                   "assets/missionfailed.png", "assets/missioncomplete.png" };
+    constexpr int REPEATS = 8;
+    constexpr int ASSET_COUNT = sizeof(assets) / sizeof(assets[0]);
+
+    auto start = benchmark_clock::now();
+    for (int i = 0; i < ASSET_COUNT * REPEATS; i++)
+    {
+        DecodedImage image;
+        if (!decode_image_file(assets[i % ASSET_COUNT], image))
+        {
+            LOG("Unable to decode " << assets[i % ASSET_COUNT] << "; run from the SDLSimple directory");
+            return false;
+        }
+        free_decoded_image(image);
+    }
+    double sequential_seconds = seconds_since(start);
+
+    LOG(ASSET_COUNT * REPEATS << " decodes");
+    LOG("threads    wall time (ms)    speedup");
+    LOG("sequential\t" << sequential_seconds * 1e3);
+
+    int max_threads = std::max((int) std::thread::hardware_concurrency(), 1);
+    for (int thread_count = 1; ; thread_count = std::min(thread_count * 2, max_threads))
+    {
+        ThreadPool pool(thread_count);
+
+        start = benchmark_clock::now();
+        {
+            ImageDecodeQueue decodes(pool);
+            for (int i = 0; i < ASSET_COUNT * REPEATS; i++) { decodes.request(assets[i % ASSET_COUNT]); }
+
+            DecodedImage image;
+            while (decodes.wait_next(image)) { free_decoded_image(image); }
+        }
+        double seconds = seconds_since(start);
+
+        LOG(thread_count << "\t\t" << seconds * 1e3 << "\t\t" << sequential_seconds / seconds << "x");
+
+        if (thread_count == max_threads) { break; }
+    }
+
+    // Baked pack: map once, then every texture is a pointer into the mapping
+    std::string pack_path = (std::filesystem::temp_directory_path() / "lunar_bench.pack").string();
+    if (!cook_texture_pack(std::vector<std::string>(assets, assets + ASSET_COUNT), pack_path.c_str())) { return false; }
+
+    start = benchmark_clock::now();
+    unsigned long long pack_checksum = 0;
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        TexturePack pack;
+        pack.open(pack_path.c_str());
+
+        for (int i = 0; i < ASSET_COUNT; i++)
+        {
+            // Touch one texel per page, as glTexImage2D's read would
+            const TexturePackEntry* entry = pack.find(assets[i]);
+            pack_checksum += sample_texels(pack.get_texels(entry), (uint64_t) entry->width * entry->height * 4);
+        }
+    }
+    double pack_seconds = seconds_since(start);
+
+    LOG("texture pack\t" << pack_seconds * 1e3 << "\t\t" << sequential_seconds / pack_seconds << "x");
+
+    // Untimed: every pack entry must hold exactly the texels stb_image decodes from its file
+    bool matches = true;
+    unsigned long long decode_checksum = 0;
+    TexturePack pack;
+    pack.open(pack_path.c_str());
+    for (int i = 0; i < ASSET_COUNT; i++)
+    {
+        DecodedImage image;
+        const TexturePackEntry* entry = pack.find(assets[i]);
+        if (entry == nullptr || !decode_image_file(assets[i], image))
+        {
+            LOG("Mismatch: " << assets[i] << " is missing from the pack or does not decode");
+            matches = false;
+            continue;
+        }
+
+        uint64_t bytes = (uint64_t) image.width * image.height * 4;
+        if ((int) entry->width != image.width || (int) entry->height != image.height ||
+            memcmp(pack.get_texels(entry), image.pixels, bytes) != 0)
+        {
+            LOG("Mismatch: " << assets[i] << " texels in the pack differ from stb_image's decode");
+            matches = false;
+        }
+        decode_checksum += sample_texels(image.pixels, bytes) * REPEATS;
+        free_decoded_image(image);
+    }
+    pack.close();
+
+    if (matches && decode_checksum != pack_checksum)
+    {
+        LOG("Mismatch: sampled texel checksum " << pack_checksum << " from the pack, " << decode_checksum << " decoded");
+        matches = false;
+    }
+    if (matches) { LOG("pack texels match stb_image decode (sampled checksum " << pack_checksum << ")"); }
+
+    std::filesystem::remove(pack_path);
+    return matches;
+}
+
+// Player position, velocity and step count: enough to tell two SimStates apart in a benchmark
+static unsigned long long const sim_state_digest(const SimState& state)
+{
+    float fields[4] = { state.player.get_position().x, state.player.get_position().y,
+                        state.player.get_velocity().x, state.player.get_velocity().y };
+    unsigned long long digest = state.step;
+    for (float field : fields)
+    {
+        uint32_t bits;
+        memcpy(&bits, &field, sizeof(bits));
+        digest = digest * 1099511628211ULL ^ bits;
+    }
+    return digest;
+}
+
+bool run_restart_benchmark()
+{
+    constexpr int ITERATIONS = 100000;
+
+    GameState state;
+    seed_game_state(state, 1);
+
+    SimState level_start;
+    snapshot_game_state(state, level_start);
+
+    // Play a little so the restore has something to undo
+    for (int i = 0; i < 60; i++) { apply_input(state, INPUT_LEFT); step_game_state(state); }
+
+    // Copies go through pointers the compiler has to reload every iteration, so none of them can be
+    // hoisted or merged; the snapshots themselves are left exactly as taken
+    GameState* volatile restore_target = &state;
+
+    auto start = benchmark_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) { restore_game_state(*restore_target, level_start); }
+    double restore_ns = seconds_since(start) * 1e9 / ITERATIONS;
+    unsigned long long restore_digest = sim_state_digest(state);
+
+    // Step on from the restore so the ring round-trips a state that differs from level_start
+    for (int i = 0; i < 60; i++) { apply_input(state, INPUT_RIGHT); step_game_state(state); }
+
+    SnapshotRing ring;
+    SimState snapshot;
+    SimState* volatile pop_target = &snapshot;
+    start = benchmark_clock::now();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        ring.push(state);
+        ring.pop(*pop_target);
+    }
+    double ring_ns = seconds_since(start) * 1e9 / ITERATIONS;
+    unsigned long long ring_digest = sim_state_digest(snapshot);
+
+    if (restore_digest != sim_state_digest(level_start) || ring_digest != sim_state_digest(state))
+    {
+        LOG("Mismatch: restored state digest " << restore_digest << ", rewind round trip " << ring_digest);
+        return false;
+    }
+
+    start = benchmark_clock::now();
+    for (int i = 0; i < ITERATIONS / 100; i++) { seed_game_state(state, i); }
+    double reseed_ns = seconds_since(start) * 1e9 / (ITERATIONS / 100);
+
+    LOG("SimState:              " << sizeof(SimState) << " bytes");
+    LOG("restore from snapshot: " << restore_ns << " ns");
+    LOG("rewind push + pop:     " << ring_ns << " ns");
+    LOG("seed_game_state:       " << reseed_ns << " ns (" << reseed_ns / restore_ns << "x the restore)");
+    LOG("state digests:         " << restore_digest << " restored, " << ring_digest << " through the rewind ring");
+    return true;
+}
+
+void run_vec_env_benchmark(int env_count)
+{
+    constexpr int STEPS = 2000;
+
+    std::vector<unsigned long long> seeds(env_count);
+    std::vector<unsigned char> actions(env_count);
+    std::vector<float> observations(env_count * LANDER_OBSERVATION_SIZE);
+    std::vector<float> rewards(env_count);
+    std::vector<unsigned char> dones(env_count);
+    for (int i = 0; i < env_count; i++) { seeds[i] = i + 1; }
+
+    LOG(env_count << " envs x " << STEPS << " steps");
+    LOG("threads    env-steps/sec    episodes    mean reward");
+
+    int max_threads = std::max((int) std::thread::hardware_concurrency(), 1);
+    for (int thread_count = 1; ; thread_count = std::min(thread_count * 2, max_threads))
+    {
+        ThreadPool pool(thread_count);
+        LanderVecEnv envs(env_count, &pool);
+        envs.reset(seeds.data(), observations.data());
+
+        long long episodes = 0;
+        double reward_sum = 0.0;
+
+        auto start = benchmark_clock::now();
+        for (int step = 0; step < STEPS; step++)
+        {
+            // Steer toward the target and hold the descent under 2 units/s
+            for (int i = 0; i < env_count; i++)
+            {
+                const float* observation = &observations[i * LANDER_OBSERVATION_SIZE];
+                float dx = observation[4] - observation[0];
+
+                unsigned char input = dx < -0.2f ? INPUT_LEFT : dx > 0.2f ? INPUT_RIGHT : 0;
+                if (observation[3] < -2.0f) { input |= INPUT_UP; }
+                actions[i] = input;
+            }
+
+            envs.step(actions.data(), observations.data(), rewards.data(), dones.data());
+
+            for (int i = 0; i < env_count; i++) { episodes += dones[i]; reward_sum += rewards[i]; }
+        }
+        double seconds = seconds_since(start);
+
+        LOG(thread_count << "\t\t" << (double) env_count * STEPS / seconds << "\t\t"
+            << episodes << "\t\t" << (episodes > 0 ? reward_sum / episodes : 0.0));
+
+        if (thread_count == max_threads) { break; }
+    }
+}
+
+void run_sweep_and_prune_benchmark()
+{
+    const int BODY_COUNTS[] = { 10, 100, 1000, 10000, 100000 };
+    constexpr int FRAMES = 60;
+    constexpr float DELTA_TIME = 1.0f / 60.0f;
+    const long long ALL_PAIRS_BUDGET = 200000000;   // narrow-phase tests per all-pairs run
+
+    LOG("bodies    all-pairs (ms/frame)    sort-and-sweep (ms/frame)    shifts/frame    pairs/frame    overlaps/frame    speedup");
+
+    for (int body_count : BODY_COUNTS)
+    {
+        // Roughly one lander per four square units, drifting at up to 2 units/s
+        float half_extent = sqrtf((float) body_count);
+        Entity probe = make_probe();
+        std::vector<Entity> bodies(body_count, probe);
+
+        srand(1);
+        for (Entity& body : bodies)
+        {
+            body.set_position(glm::vec3((rand() / (float) RAND_MAX) * 2.0f * half_extent - half_extent,
+                                        (rand() / (float) RAND_MAX) * 2.0f * half_extent - half_extent, 0.0f));
+            body.set_velocity(glm::vec3((rand() / (float) RAND_MAX) * 4.0f - 2.0f,
+                                        (rand() / (float) RAND_MAX) * 4.0f - 2.0f, 0.0f));
+        }
+
+        // All pairs on the starting layout; past the budget only the first rows
+        // are tested and the time is scaled up to a whole frame
+        long long total_tests = (long long) body_count * (body_count - 1) / 2;
+        long long tested = 0;
+        int all_pairs_hits = 0;
+
+        auto start = benchmark_clock::now();
+        for (int i = 0; i < body_count && tested < ALL_PAIRS_BUDGET; i++)
+        {
+            for (int j = i + 1; j < body_count; j++) { all_pairs_hits += bodies[i].check_collision(&bodies[j]); }
+            tested += body_count - 1 - i;
+        }
+        double all_pairs_ms = seconds_since(start) * 1e3 * ((double) total_tests / std::max(tested, 1LL));
+        bool all_pairs_complete = tested == total_tests;
+
+        SweepAndPrune sweep;
+        std::vector<OverlapPair> pairs;
+        for (int i = 0; i < body_count; i++)
+        {
+            sweep.insert(i, bodies[i].get_position(), bodies[i].get_width(), bodies[i].get_height());
+        }
+
+        // The first frame sorts from scratch and must agree with all pairs
+        sweep.find_pairs(pairs);
+        int sweep_hits = 0;
+        for (const OverlapPair& pair : pairs) { sweep_hits += bodies[pair.a].check_collision(&bodies[pair.b]); }
+        if (all_pairs_complete && sweep_hits != all_pairs_hits)
+        {
+            LOG("Mismatch at " << body_count << " bodies: all pairs " << all_pairs_hits << ", sort-and-sweep " << sweep_hits);
+            return;
+        }
+
+        double sweep_seconds = 0.0;
+        long long shifts = 0, pair_count = 0, overlap_count = 0;
+        for (int frame = 0; frame < FRAMES; frame++)
+        {
+            for (Entity& body : bodies)
+            {
+                glm::vec3 position = body.get_position() + body.get_velocity() * DELTA_TIME;
+                glm::vec3 velocity = body.get_velocity();
+                if (fabsf(position.x) > half_extent) { velocity.x = -velocity.x; }
+                if (fabsf(position.y) > half_extent) { velocity.y = -velocity.y; }
+                body.set_position(position);
+                body.set_velocity(velocity);
+            }
+
+            start = benchmark_clock::now();
+            for (int i = 0; i < body_count; i++)
+            {
+                sweep.move(i, bodies[i].get_position(), bodies[i].get_width(), bodies[i].get_height());
+            }
+
+            pairs.clear();
+            sweep.find_pairs(pairs);
+            for (const OverlapPair& pair : pairs) { overlap_count += bodies[pair.a].check_collision(&bodies[pair.b]); }
+            sweep_seconds += seconds_since(start);
+
+            shifts += sweep.get_last_shift_count();
+            pair_count += pairs.size();
+        }
+        double sweep_ms = sweep_seconds * 1e3 / FRAMES;
+
+        LOG(body_count << "\t\t" << all_pairs_ms << (all_pairs_complete ? "" : " (est.)") << "\t\t" << sweep_ms
+            << "\t\t" << shifts / FRAMES << "\t\t" << pair_count / FRAMES << "\t\t" << overlap_count / FRAMES
+            << "\t\t" << all_pairs_ms / sweep_ms << "x");
+    }
+}
+
+bool run_integrator_benchmark()
+{
+    constexpr int BODY_COUNT = 100003;   // not a multiple of 8, so the scalar tail runs too
+    constexpr int STEPS = 60;
+    // Relative: a coordinate near 50 rounds in 4e-6 steps, and 60 steps of that add up
+    constexpr float TOLERANCE = 1e-5f;
+
+    // Random starts, a third of them already over the speed limit
+    std::vector<Entity> entities(BODY_COUNT);
+    std::vector<float> x(BODY_COUNT), y(BODY_COUNT), velocity_x(BODY_COUNT), velocity_y(BODY_COUNT);
+    std::vector<float> acceleration_x(BODY_COUNT), acceleration_y(BODY_COUNT);
+
+    srand(1);
+    for (int i = 0; i < BODY_COUNT; i++)
+    {
+        float speed = (i % 3 == 0) ? 8.0f : 3.0f;
+        x[i] = (rand() / (float) RAND_MAX) * 100.0f - 50.0f;
+        y[i] = (rand() / (float) RAND_MAX) * 100.0f - 50.0f;
+        velocity_x[i] = ((rand() / (float) RAND_MAX) * 2.0f - 1.0f) * speed;
+        velocity_y[i] = ((rand() / (float) RAND_MAX) * 2.0f - 1.0f) * speed;
+        acceleration_x[i] = (rand() / (float) RAND_MAX) * 2.0f - 1.0f;
+        acceleration_y[i] = (i % 5 == 0) ? 0.0f : DEFAULT_GRAVITY * 0.1f;
+
+        entities[i].set_position(glm::vec3(x[i], y[i], 0.0f));
+        entities[i].set_velocity(glm::vec3(velocity_x[i], velocity_y[i], 0.0f));
+        entities[i].set_acceleration(glm::vec3(acceleration_x[i], acceleration_y[i], 0.0f));
+    }
+    // One body that never moves: the kernel must not turn 0 / 0 into NaN
+    velocity_x[1] = velocity_y[1] = acceleration_x[1] = acceleration_y[1] = 0.0f;
+    entities[1].set_velocity(glm::vec3(0.0f));
+    entities[1].set_acceleration(glm::vec3(0.0f));
+
+    auto start = benchmark_clock::now();
+    for (int step = 0; step < STEPS; step++)
+    {
+        for (Entity& entity : entities) { entity.update(FIXED_TIMESTEP, nullptr); }
+    }
+    double entity_ns = seconds_since(start) * 1e9 / ((double) STEPS * BODY_COUNT);
+
+    start = benchmark_clock::now();
+    for (int step = 0; step < STEPS; step++)
+    {
+        integrate_bodies(x.data(), y.data(), velocity_x.data(), velocity_y.data(),
+                         acceleration_x.data(), acceleration_y.data(), BODY_COUNT, FIXED_TIMESTEP, Entity::MAX_VELOCITY);
+    }
+    double kernel_ns = seconds_since(start) * 1e9 / ((double) STEPS * BODY_COUNT);
+
+    auto relative_error = [](float expected, float actual) { return fabsf(actual - expected) / std::max(fabsf(expected), 1.0f); };
+
+    float worst_position = 0.0f, worst_velocity = 0.0f;
+    for (int i = 0; i < BODY_COUNT; i++)
+    {
+        glm::vec3 position = entities[i].get_position();
+        glm::vec3 velocity = entities[i].get_velocity();
+        worst_position = std::max({ worst_position, relative_error(position.x, x[i]), relative_error(position.y, y[i]) });
+        worst_velocity = std::max({ worst_velocity, relative_error(velocity.x, velocity_x[i]), relative_error(velocity.y, velocity_y[i]) });
+    }
+    bool agrees = worst_position <= TOLERANCE && worst_velocity <= TOLERANCE && !std::isnan(x[1] + y[1]);
+
+    LOG(BODY_COUNT << " bodies x " << STEPS << " steps");
+    LOG("Entity::update:   " << entity_ns << " ns/body");
+    LOG("integrate_bodies: " << kernel_ns << " ns/body (" << entity_ns / kernel_ns << "x)");
+    LOG("max relative difference: position " << worst_position << ", velocity " << worst_velocity
+        << (agrees ? " (within " : " (OUTSIDE ") << TOLERANCE << ")");
+    return agrees;
+}
+
+void run_frame_pacer_benchmark()
+{
+    constexpr double SECONDS_PER_RUN = 1.0;
+    constexpr uint64_t WORK_NS = 2000000;   // a 2 ms frame, busy the whole time
+
+    LOG("2 ms of work per frame, " << SECONDS_PER_RUN << " s per row");
+    LOG("target fps    achieved fps    frame ms    cpu ms/frame    cpu %    max late ms");
+
+    for (float target_fps : { 0.0f, 30.0f, 60.0f, 144.0f, 240.0f })
+    {
+        FramePacer pacer(target_fps);
+        pacer.wait();   // first wake: stats count from here
+        pacer.reset_stats();
+
+        uint64_t start_cpu = thread_cpu_ns();
+        auto start = benchmark_clock::now();
+        while (seconds_since(start) < SECONDS_PER_RUN)
+        {
+            uint64_t work_end = pacer_now_ns() + WORK_NS;
+            while (pacer_now_ns() < work_end) {}
+            pacer.wait();
+        }
+        double elapsed = seconds_since(start);
+        double cpu_seconds = (thread_cpu_ns() - start_cpu) * 1e-9;
+
+        FramePacerStats stats = pacer.get_stats();
+        LOG((target_fps > 0.0f ? std::to_string((int) target_fps) : std::string("unpaced")) << "            "
+            << stats.frames / elapsed << "            " << stats.average_frame_ms << "        "
+            << stats.average_cpu_ms << "            " << 100.0 * cpu_seconds / elapsed << "      " << stats.max_late_ms);
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+// Linear scan vs UniformGrid vs StaticBvh broadphase, plus BVH altitude rays, at 10, 1k, 100k and 1M platforms;
+// false when the three disagree on which platforms the queries touch
+bool run_broadphase_benchmark();
+
+// All-pairs vs incremental sort-and-sweep for 10 to 100k landers colliding with each other
+void run_sweep_and_prune_benchmark();
+
+// Entity::update vs the integrate_bodies kernel over 100k bodies; false when they disagree
+bool run_integrator_benchmark();
+
+// Array-of-Entity scan vs EntityPool (scalar and batched) scan
+void run_pool_benchmark();
+
+// Sequential stbi decode vs ImageDecodeQueue (1, 2, 4 ... threads) vs a mapped texture pack;
+// false when the pack's texels differ from the decode
+bool run_texture_decode_benchmark();
+
+// SimState snapshot / restore / rewind-ring cost vs re-laying the level out from scratch;
+// false when a restore or a rewind round trip does not reproduce the state
+bool run_restart_benchmark();
+
+// LanderVecEnv env-steps/sec for `env_count` landers on 1, 2, 4 ... threads
+void run_vec_env_benchmark(int env_count);
+
+// FramePacer at 30 to 240 fps around a 2 ms frame: achieved rate, CPU per frame and wake-up lateness
+void run_frame_pacer_benchmark();
+
+#endif // BENCHMARKS_H
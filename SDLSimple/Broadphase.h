@@ -0,0 +1,23 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include <vector>
+#include "glm/glm.hpp"
+
+/**
+ * What Entity's collision checks need from a broadphase: the ids of every
+ * collidable that might overlap a box. StaticBvh serves the level geometry the
+ * game steps against; UniformGrid, for boxes that move, is only benchmarked.
+ */
+class Broadphase
+{
+public:
+    virtual ~Broadphase() = default;
+
+    // Appends the ids of every box that may overlap the query box, sorted
+    // ascending and without duplicates, so callers can narrow-phase them in the
+    // same order a linear scan would.
+    virtual void query(glm::vec3 position, float width, float height, std::vector<int>& out) const = 0;
+};
+
+#endif // BROADPHASE_H
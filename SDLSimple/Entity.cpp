@@ -7,106 +7,181 @@
 * NYU School of Engineering Policies and Procedures on
 * Academic Misconduct.
 **/
-#define GL_SILENCE_DEPRECATION
-#define STB_IMAGE_IMPLEMENTATION
-
-#ifdef _WINDOWS
-#include <GL/glew.h>
-#endif
-
-#define GL_GLEXT_PROTOTYPES 1
-#include <SDL.h>
-#include <SDL_opengl.h>
+#include <algorithm>
+#include <cmath>
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
-#include "ShaderProgram.h"
+#include "AabbBatch.h"
+#include "Broadphase.h"
+#include "EntityPool.h"
 #include "Entity.h"
+#include "Profiler.h"
 
-Entity::Entity()
+// Scratch list of broadphase candidates, reused across calls so a step never allocates
+static thread_local std::vector<int> s_candidates;
+
+static int const gather_candidates(const Broadphase* broadphase, int collidable_entity_count,
+                                   glm::vec3 position, float width, float height)
 {
-    m_position = glm::vec3(0.0f);
-    m_velocity = glm::vec3(0.0f);
-    m_acceleration = glm::vec3(0.0f);
-    m_movement = glm::vec3(0.0f);
-    m_speed = 0;
-    m_model_matrix = glm::mat4(1.0f);
-}
+    s_candidates.clear();
+
+    if (broadphase == nullptr) { return collidable_entity_count; }
 
-Entity::~Entity(){};
+    broadphase->query(position, width, height, s_candidates);
+    return (int) s_candidates.size();
+}
 
-CollisionType const Entity::check_collision_y(Entity* collidable_entities, int collidable_entity_count)
+// Finds the first candidate slot at or after `first` whose collidable overlaps the given box, testing
+// AABB_BATCH_WIDTH of them per kernel call. Returns candidate_count when there is none.
+static int const next_overlap(const EntityPool* collidables, bool use_candidates, int first, int candidate_count,
+                              glm::vec3 position, float width, float height,
+                              float* x_overlap, float* y_overlap)
 {
-    CollisionType result = NOCOLLISION;
+    AabbBatch batch;
+    float batch_x_overlap[AABB_BATCH_WIDTH];
+    float batch_y_overlap[AABB_BATCH_WIDTH];
+
+    const float* x           = collidables->get_x();
+    const float* y           = collidables->get_y();
+    const float* half_width  = collidables->get_half_width();
+    const float* half_height = collidables->get_half_height();
+    const unsigned char* flags = collidables->get_flags();
 
-    for (int i = 0; i < collidable_entity_count; i++)
+    for (int start = first; start < candidate_count; start += AABB_BATCH_WIDTH)
     {
-        Entity* collidable_entity = &collidable_entities[i];
+        unsigned int hits;
 
-        if (check_collision(collidable_entity))
+        if (!use_candidates && start + AABB_BATCH_WIDTH <= candidate_count)
         {
-            float y_distance = fabs(m_position.y - collidable_entity->m_position.y);
-            float y_overlap = fabs(y_distance - (m_height / 2.0f) - (collidable_entity->m_height / 2.0f));
-
-            if (m_velocity.y > 0) {
-                m_position.y -= y_overlap;
-                m_velocity.y = 0;
-                m_collided_top = true;
-            }
-            else if (m_velocity.y < 0) {
-                m_position.y += y_overlap;
-                m_velocity.y = 0;
-                m_collided_bottom = true;
+            // Slots are pool indices, so the kernel reads the pool's arrays in place
+            hits = aabb_overlap_arrays(position.x, position.y, width / 2.0f, height / 2.0f,
+                                       x + start, y + start, half_width + start, half_height + start,
+                                       batch_x_overlap, batch_y_overlap);
+        }
+        else
+        {
+            // Broadphase candidates are scattered through the pool, and the last few slots may not fill a batch
+            for (int lane = 0; lane < AABB_BATCH_WIDTH; lane++)
+            {
+                int slot = start + lane;
+
+                // Lanes past the last candidate must not read the candidate list or the pool
+                if (slot >= candidate_count)
+                {
+                    aabb_batch_clear_lane(batch, lane);
+                    continue;
+                }
+
+                int index = use_candidates ? s_candidates[slot] : slot;
+                batch.x[lane]           = x[index];
+                batch.y[lane]           = y[index];
+                batch.half_width[lane]  = half_width[index];
+                batch.half_height[lane] = half_height[index];
             }
 
-            if (collidable_entity->get_platform_type() == NORMAL) {
-                result = GROUND;
-            }
-            else if (collidable_entity->get_platform_type() == TRAP) {
-                result = HITTARGET;
-            }
+            hits = aabb_overlap_batch(position.x, position.y, width / 2.0f, height / 2.0f,
+                                      batch, batch_x_overlap, batch_y_overlap);
+        }
+
+        // Inactive collidables are dropped from the hits here, once something overlaps, not per lane up front
+        for (int lane = 0; hits != 0; lane++, hits >>= 1)
+        {
+            if (!(hits & 1u)) { continue; }
+
+            int slot = start + lane;
+            int index = use_candidates ? s_candidates[slot] : slot;
+            if (!(flags[index] & ENTITY_ACTIVE)) { continue; }
+
+            *x_overlap = batch_x_overlap[lane];
+            *y_overlap = batch_y_overlap[lane];
+            return slot;
         }
     }
-    return result;
-};
 
-CollisionType const Entity::check_collision_x(Entity* collidable_entities, int collidable_entity_count)
+    return candidate_count;
+}
+
+Entity::Entity()
 {
+    m_position = glm::vec3(0.0f);
+    m_previous_position = glm::vec3(0.0f);
+    m_velocity = glm::vec3(0.0f);
+    m_acceleration = glm::vec3(0.0f);
+    m_movement = glm::vec3(0.0f);
+    m_speed = 0;
+    m_model_matrix = glm::mat4(1.0f);
+}
+
 
+CollisionType const Entity::resolve_collisions(EntityPool* collidables, const Broadphase* broadphase)
+{
+    PROFILE_ZONE("resolve_collisions");
     CollisionType result = NOCOLLISION;
+    if (!m_is_active) { return result; }
+
+    // A push can open an overlap with a candidate already passed, so scan again until one comes up clean
+    const int MAX_PASSES = 3;
+
+    const float* x = collidables->get_x();
+    const float* y = collidables->get_y();
+    const unsigned char* flags = collidables->get_flags();
 
-    for (int i = 0; i < collidable_entity_count; i++)
+    float x_overlap, y_overlap;
+    m_contact_count = 0;
+
+    for (int pass = 0; pass < MAX_PASSES; pass++)
     {
-        Entity* collidable_entity = &collidable_entities[i];
+        // Gathered again each pass: the pushes may have carried this entity into new cells
+        int candidate_count = gather_candidates(broadphase, collidables->size(), m_position, m_width, m_height);
+        bool pushed = false;
 
-        if (check_collision(collidable_entity))
+        // Each resolution moves this entity, so the search resumes after the hit from the new position
+        for (int i = 0; i < candidate_count; i++)
         {
-            float x_distance = fabs(m_position.x - collidable_entity->m_position.x);
-            float x_overlap = fabs(x_distance - (m_width / 2.0f) - (collidable_entity->m_width / 2.0f));
-            if (m_velocity.x > 0) {
-                m_position.x -= x_overlap;
-                m_velocity.x = 0;
-                m_collided_right = true;
+            i = next_overlap(collidables, broadphase != nullptr, i, candidate_count,
+                             m_position, m_width, m_height, &x_overlap, &y_overlap);
+            if (i == candidate_count) { break; }
+
+            int index = broadphase ? s_candidates[i] : i;
+
+            // Push out along whichever axis is overlapped least; an exact corner counts as landing on top
+            Contact contact;
+            contact.index = index;
+            contact.platform_type = (flags[index] & ENTITY_TRAP) ? TRAP : NORMAL;
+            if (y_overlap <= x_overlap)
+            {
+                contact.normal = glm::vec3(0.0f, m_position.y >= y[index] ? 1.0f : -1.0f, 0.0f);
+                contact.penetration = y_overlap;
             }
-            else if (m_velocity.x < 0) {
-                m_position.x += x_overlap;
-                m_velocity.x = 0;
-                m_collided_left = true;
+            else
+            {
+                contact.normal = glm::vec3(m_position.x >= x[index] ? 1.0f : -1.0f, 0.0f, 0.0f);
+                contact.penetration = x_overlap;
             }
 
-            if (collidable_entity->get_platform_type() == NORMAL) {
-                result = GROUND;
-            }
-            else if (collidable_entity->get_platform_type() == TRAP) {
-                result = HITTARGET;
-            }
+            m_position += contact.normal * contact.penetration;
+            pushed = true;
 
+            if      (contact.normal.y > 0.0f) { m_collided_bottom = true; m_velocity.y = std::max(m_velocity.y, 0.0f); }
+            else if (contact.normal.y < 0.0f) { m_collided_top    = true; m_velocity.y = std::min(m_velocity.y, 0.0f); }
+            else if (contact.normal.x > 0.0f) { m_collided_left   = true; m_velocity.x = std::max(m_velocity.x, 0.0f); }
+            else                              { m_collided_right  = true; m_velocity.x = std::min(m_velocity.x, 0.0f); }
+
+            if (m_contact_count < MAX_CONTACTS) { m_contacts[m_contact_count++] = contact; }
+
+            // Touching any ordinary platform is a crash, even if the target was touched too
+            if (result != GROUND) { result = contact.platform_type == TRAP ? HITTARGET : GROUND; }
         }
+
+        if (!pushed) { break; }
     }
     return result;
 };
 
-CollisionType Entity::update(float delta_time, Entity* collidable_entities, int collidable_entity_count)
+CollisionType Entity::update(float delta_time, EntityPool* collidables, const Broadphase* broadphase)
 {
+    m_previous_position = m_position;
+
     if (!m_is_active) { return NOCOLLISION; };
 
     m_collided_top = false;
@@ -116,48 +191,131 @@ CollisionType Entity::update(float delta_time, Entity* collidable_entities, int
 
     m_velocity += m_acceleration * delta_time;
 
-    const float MAX_VELOCITY = 5.0f;
     if (glm::length(m_velocity) > MAX_VELOCITY)
     {
         m_velocity = glm::normalize(m_velocity) * MAX_VELOCITY;
     }
 
-    m_position += m_velocity * delta_time;
-
-    CollisionType y_direction = check_collision_y(collidable_entities, collidable_entity_count);
-    CollisionType x_direction = check_collision_x(collidable_entities, collidable_entity_count);
+    CollisionType result = NOCOLLISION;
 
-    if (y_direction == GROUND || x_direction == GROUND) {
-        return GROUND;
+    if (m_collision_mode == SWEPT && collidables != nullptr)
+    {
+        result = move_swept(m_velocity * delta_time, collidables, broadphase);
     }
-    else if (y_direction == HITTARGET || x_direction == HITTARGET) {
-        return HITTARGET;
+    else
+    {
+        m_position += m_velocity * delta_time;
+
+        if (collidables != nullptr) { result = resolve_collisions(collidables, broadphase); }
     }
-        
+
+    // Rebuilt on collision steps too, so the drawn lander rests where it actually landed
     m_model_matrix = glm::mat4(1.0f);
     m_model_matrix = glm::translate(m_model_matrix, m_position);
 
-    return NOCOLLISION;
+    return result;
 };
 
-void Entity::render(ShaderProgram* program)
+bool const Entity::sweep(EntityPool* collidables, glm::vec3 displacement, SweepHit* hit,
+                         const Broadphase* broadphase) const
 {
-    program->set_model_matrix(m_model_matrix);
+    if (!m_is_active) { return false; }
+
+    // Broadphase over the box that covers the whole move
+    glm::vec3 swept_centre = m_position + displacement / 2.0f;
+    int candidate_count = gather_candidates(broadphase, collidables->size(), swept_centre,
+                                            m_width + fabs(displacement.x), m_height + fabs(displacement.y));
+
+    const float* x           = collidables->get_x();
+    const float* y           = collidables->get_y();
+    const float* half_width  = collidables->get_half_width();
+    const float* half_height = collidables->get_half_height();
+    const unsigned char* flags = collidables->get_flags();
+
+    bool found = false;
+    hit->time = 1.0f;
+
+    for (int i = 0; i < candidate_count; i++)
+    {
+        int index = broadphase ? s_candidates[i] : i;
+        if (!(flags[index] & ENTITY_ACTIVE)) { continue; }
+
+        // Sweep this entity's centre as a ray against the collidable grown by our half extents
+        float x_reach = m_width  / 2.0f + half_width[index];
+        float y_reach = m_height / 2.0f + half_height[index];
+
+        float x_entry = -INFINITY, x_exit = INFINITY;
+        if (displacement.x != 0.0f)
+        {
+            float x_first = (x[index] - x_reach - m_position.x) / displacement.x;
+            float x_second = (x[index] + x_reach - m_position.x) / displacement.x;
+            x_entry = fminf(x_first, x_second);
+            x_exit  = fmaxf(x_first, x_second);
+        }
+        else if (fabs(m_position.x - x[index]) >= x_reach) { continue; }
 
-    float vertices[] = { -0.5, -0.5, 0.5, -0.5, 0.5, 0.5, -0.5, -0.5, 0.5, 0.5, -0.5, 0.5 };
-    float tex_coords[] = { 0.0,  1.0, 1.0,  1.0, 1.0, 0.0,  0.0,  1.0, 1.0, 0.0,  0.0, 0.0 };
+        float y_entry = -INFINITY, y_exit = INFINITY;
+        if (displacement.y != 0.0f)
+        {
+            float y_first = (y[index] - y_reach - m_position.y) / displacement.y;
+            float y_second = (y[index] + y_reach - m_position.y) / displacement.y;
+            y_entry = fminf(y_first, y_second);
+            y_exit  = fmaxf(y_first, y_second);
+        }
+        else if (fabs(m_position.y - y[index]) >= y_reach) { continue; }
 
-    glBindTexture(GL_TEXTURE_2D, m_texture_id);
+        float entry = fmaxf(x_entry, y_entry);
+        float exit  = fminf(x_exit, y_exit);
 
-    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, 0, vertices);
-    glEnableVertexAttribArray(program->get_position_attribute());
-    glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, 0, tex_coords);
-    glEnableVertexAttribArray(program->get_tex_coordinate_attribute());
+        // Touching faces (entry == exit) is not an overlap, matching check_collision
+        if (entry >= exit || exit <= 0.0f || entry >= hit->time) { continue; }
 
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+        found = true;
+        hit->time = fmaxf(entry, 0.0f);
+        hit->index = index;
+        hit->normal = x_entry > y_entry ? glm::vec3(displacement.x > 0.0f ? -1.0f : 1.0f, 0.0f, 0.0f)
+                                        : glm::vec3(0.0f, displacement.y > 0.0f ? -1.0f : 1.0f, 0.0f);
+    }
 
-    glDisableVertexAttribArray(program->get_position_attribute());
-    glDisableVertexAttribArray(program->get_tex_coordinate_attribute());
+    return found;
+};
+
+CollisionType const Entity::move_swept(glm::vec3 displacement, EntityPool* collidables, const Broadphase* broadphase)
+{
+    PROFILE_ZONE("move_swept");
+    // After stopping on one face the rest of the move slides along it, and may meet one more face
+    const int MAX_SWEEPS = 3;
+
+    CollisionType result = NOCOLLISION;
+    SweepHit hit;
+
+    if (displacement.x == 0.0f && displacement.y == 0.0f) { return result; }
+
+    for (int sweep_count = 0; sweep_count < MAX_SWEEPS; sweep_count++)
+    {
+        if (!sweep(collidables, displacement, &hit, broadphase))
+        {
+            m_position += displacement;
+            break;
+        }
+
+        m_position += displacement * hit.time + hit.normal * CONTACT_SKIN;
+        result = (collidables->get_flags()[hit.index] & ENTITY_TRAP) ? HITTARGET : GROUND;
+
+        if      (hit.normal.y > 0.0f) { m_collided_bottom = true; m_velocity.y = 0; }
+        else if (hit.normal.y < 0.0f) { m_collided_top    = true; m_velocity.y = 0; }
+        else if (hit.normal.x > 0.0f) { m_collided_left   = true; m_velocity.x = 0; }
+        else                          { m_collided_right  = true; m_velocity.x = 0; }
+
+        // Keep only the part of the remaining move that runs along the face
+        displacement *= 1.0f - hit.time;
+        if (hit.normal.x != 0.0f) { displacement.x = 0.0f; }
+        else                      { displacement.y = 0.0f; }
+
+        if (displacement.x == 0.0f && displacement.y == 0.0f) { break; }
+    }
+
+    return result;
 };
 
 bool const Entity::check_collision(Entity* other) const
@@ -169,3 +327,20 @@ bool const Entity::check_collision(Entity* other) const
 
     return x_distance < 0.0f && y_distance < 0.0f;
 };
+
+bool const Entity::check_collision(const EntityPool* pool, int index) const
+{
+    if (!m_is_active || !(pool->get_flags()[index] & ENTITY_ACTIVE)) { return false; };
+
+    return overlap_x(pool, index) > 0.0f && overlap_y(pool, index) > 0.0f;
+};
+
+float const Entity::overlap_x(const EntityPool* pool, int index) const
+{
+    return (m_width / 2.0f + pool->get_half_width()[index]) - fabsf(m_position.x - pool->get_x()[index]);
+}
+
+float const Entity::overlap_y(const EntityPool* pool, int index) const
+{
+    return (m_height / 2.0f + pool->get_half_height()[index]) - fabsf(m_position.y - pool->get_y()[index]);
+}
@@ -2,16 +2,44 @@
 #define ENTITY_H
 
 #include "glm/glm.hpp"
-#include "ShaderProgram.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include "TextureAtlas.h"
+class SpriteBatch;
+class Broadphase;
+class EntityPool;
 
 enum CollisionType { HITTARGET, GROUND, NOCOLLISION };
 enum PlatformType { NORMAL, TRAP };
 
+// DISCRETE moves then pushes out of overlaps; SWEPT finds the time of impact first, so nothing tunnels at large steps
+enum CollisionMode { DISCRETE, SWEPT };
+
+// Earliest contact found by Entity::sweep
+struct SweepHit
+{
+    float     time;     // fraction of the displacement travelled before touching, in [0, 1)
+    glm::vec3 normal;   // face normal of the collidable that was hit
+    int       index;    // collidable's slot in the pool
+};
+
+// One overlapping pair from Entity::resolve_collisions
+struct Contact
+{
+    glm::vec3    normal = glm::vec3(0.0f);   // axis the entity was pushed out along, away from the collidable
+    float        penetration = 0.0f;          // overlap along that axis before the push
+    PlatformType platform_type = NORMAL;
+    int          index = -1;                  // collidable's slot in the pool
+};
+
+// Contacts an Entity keeps per resolve_collisions; any beyond this are still resolved, just not recorded
+constexpr int MAX_CONTACTS = 8;
+
 class Entity
 {
 private:
     CollisionType m_collision_type = NOCOLLISION;
     PlatformType m_platform_type = NORMAL;
+    CollisionMode m_collision_mode = DISCRETE;
     
     bool  m_is_jumping = false;
     bool m_is_active = true;
@@ -19,6 +47,7 @@ private:
     // ————— TRANSFORMATIONS ————— //
     glm::vec3 m_movement;
     glm::vec3 m_position;
+    glm::vec3 m_previous_position;   // position before the last update, for render interpolation
     glm::vec3 m_velocity;
     glm::vec3 m_acceleration;
     float     m_speed;
@@ -26,7 +55,9 @@ private:
     glm::mat4 m_model_matrix;
 
     // ————— TEXTURES ————— //
-    GLuint    m_texture_id;
+    // Atlas page (a GL texture name, kept as a plain integer so the physics core
+    // needs no GL headers) and the part of it this entity draws
+    AtlasSprite m_sprite;
 
     float m_width = 1.0f,
           m_height = 1.0f;
@@ -35,22 +66,39 @@ private:
     bool m_collided_bottom = false;
     bool m_collided_left   = false;
     bool m_collided_right  = false;
-    
+    Contact m_contacts[MAX_CONTACTS];   // from the last resolve_collisions, in resolution order
+    int     m_contact_count = 0;
+
+    CollisionType const move_swept(glm::vec3 displacement, EntityPool* collidables, const Broadphase* broadphase);
 
 public:
     // ————— STATIC VARIABLES ————— //
     static constexpr int SECONDS_PER_FRAME = 4;
+    static constexpr float MAX_VELOCITY = 5.0f;
+    // Swept moves stop this far off a face, so rounding cannot leave the box a hair inside it
+    static constexpr float CONTACT_SKIN = 1e-4f;
 
     // ————— METHODS ————— //
     Entity();
-    ~Entity();
+    // Defaulted so Entity stays trivially copyable and can sit inside a SimState snapshot
+    ~Entity() = default;
     
     bool const check_collision(Entity* other) const;
-    CollisionType const check_collision_y(Entity* collidable_entities, int collidable_entity_count);
-    CollisionType const check_collision_x(Entity* collidable_entities, int collidable_entity_count);
+    bool const check_collision(const EntityPool* pool, int index) const;
+    // Penetration into pool slot `index` along each axis (sum of half extents - centre distance),
+    // the depth resolve_collisions pushes by; check_collision is both being positive
+    float const overlap_x(const EntityPool* pool, int index) const;
+    float const overlap_y(const EntityPool* pool, int index) const;
+    // One narrow-phase pass: every overlap becomes a Contact on its least-penetrated axis,
+    // is resolved along it and sets the matching m_collided_* flag
+    CollisionType const resolve_collisions(EntityPool* collidables, const Broadphase* broadphase = nullptr);
+    bool const sweep(EntityPool* collidables, glm::vec3 displacement, SweepHit* hit,
+                     const Broadphase* broadphase = nullptr) const;
     
-    CollisionType update(float delta_time, Entity* collidable_entities, int collidable_entity_count);
-    void render(ShaderProgram* program);
+    // With a broadphase, only the collidables it reports near this entity are narrow-phase tested
+    CollisionType update(float delta_time, EntityPool* collidables, const Broadphase* broadphase = nullptr);
+    // Draws at the blend of the previous and current step positions; defined in EntityRender.cpp
+    void render(SpriteBatch* batch, float alpha = 1.0f) const;
 
     void normalise_movement() { m_movement = glm::normalize(m_movement); }
     
@@ -67,29 +115,34 @@ public:
     // ————— GETTERS ————— //
     CollisionType const get_collison_type()    const { return m_collision_type; };
     PlatformType const get_platform_type()    const { return m_platform_type; };
+    CollisionMode const get_collision_mode()  const { return m_collision_mode; };
     glm::vec3 const get_position()     const { return m_position; }
+    glm::vec3 const get_previous_position() const { return m_previous_position; }
     glm::vec3 const get_velocity()     const { return m_velocity; }
     glm::vec3 const get_acceleration() const { return m_acceleration; }
     glm::vec3 const get_movement()     const { return m_movement; }
-    GLuint    const get_texture_id()   const { return m_texture_id; }
+    const AtlasSprite& get_sprite()    const { return m_sprite; }
     float     const get_speed()        const { return m_speed; }
-    int       const get_width()        const { return m_width; };
-    int       const get_height()       const { return m_height; };
+    float     const get_width()        const { return m_width; };
+    float     const get_height()       const { return m_height; };
     
     bool      const get_collided_top() const { return m_collided_top; }
     bool      const get_collided_bottom() const { return m_collided_bottom; }
     bool      const get_collided_right() const { return m_collided_right; }
     bool      const get_collided_left() const { return m_collided_left; }
+    const Contact*    get_contacts()      const { return m_contacts; }
+    int       const get_contact_count() const { return m_contact_count; }
     
     // ————— SETTERS ————— //
     void const set_collisioin_type(CollisionType new_collision_type)  { m_collision_type = new_collision_type;};
     void const set_platform_type(PlatformType new_platform_type)  { m_platform_type = new_platform_type;};
+    void const set_collision_mode(CollisionMode new_collision_mode)  { m_collision_mode = new_collision_mode;};
 
-    void const set_position(glm::vec3 new_position) { m_position = new_position; }
+    void const set_position(glm::vec3 new_position) { m_position = new_position; m_previous_position = new_position; }
     void const set_velocity(glm::vec3 new_velocity) { m_velocity = new_velocity; }
     void const set_acceleration(glm::vec3 new_acceleration) { m_acceleration = new_acceleration; }
     void const set_movement(glm::vec3 new_movement) { m_movement = new_movement; }
-    void const set_texture_id(GLuint new_texture_id) { m_texture_id = new_texture_id; }
+    void const set_sprite(const AtlasSprite& new_sprite) { m_sprite = new_sprite; }
     void const set_speed(float new_speed) { m_speed = new_speed; }
 
     void const set_width(float new_width) {m_width = new_width; }
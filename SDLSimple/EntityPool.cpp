@@ -0,0 +1,29 @@
+#include "EntityPool.h"
+
+EntityPool::EntityPool(int count)
+{
+    resize(count);
+}
+
+void EntityPool::resize(int count)
+{
+    // New slots match a default-constructed Entity: active, 1x1, NORMAL
+    m_x.resize(count, 0.0f);
+    m_y.resize(count, 0.0f);
+    m_half_width.resize(count, 0.5f);
+    m_half_height.resize(count, 0.5f);
+    m_flags.resize(count, ENTITY_ACTIVE);
+
+    m_velocity_x.resize(count, 0.0f);
+    m_velocity_y.resize(count, 0.0f);
+
+    m_sprite.resize(count);
+    m_scale.resize(count, glm::vec3(1.0f));
+}
+
+int EntityPool::add()
+{
+    int index = size();
+    resize(index + 1);
+    return index;
+}
@@ -0,0 +1,99 @@
+#ifndef ENTITY_POOL_H
+#define ENTITY_POOL_H
+
+#include <vector>
+#include "glm/glm.hpp"
+#include "Entity.h"
+
+class SpriteBatch;
+class InstancedQuads;
+
+enum EntityFlag : unsigned char
+{
+    ENTITY_ACTIVE = 1 << 0,
+    ENTITY_TRAP   = 1 << 1
+};
+
+/**
+ * Structure-of-arrays storage for large numbers of simple entities (platform
+ * tiles). The fields a collision scan reads live in their own contiguous
+ * arrays, apart from the render-only data, so a scan only streams the bytes it
+ * actually needs instead of whole Entity objects.
+ */
+class EntityPool
+{
+private:
+    // ————— HOT: read by every collision scan ————— //
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_half_width;
+    std::vector<float> m_half_height;
+    std::vector<unsigned char> m_flags;
+
+    std::vector<float> m_velocity_x;
+    std::vector<float> m_velocity_y;
+
+    // ————— COLD: only touched when rendering ————— //
+    std::vector<AtlasSprite> m_sprite;
+    std::vector<glm::vec3> m_scale;
+
+public:
+    // Thin view onto one slot, so call sites read like they did with Entity
+    class Handle
+    {
+    private:
+        EntityPool* m_pool;
+        int m_index;
+
+    public:
+        Handle(EntityPool* pool, int index) : m_pool(pool), m_index(index) {}
+
+        void activate()   { m_pool->m_flags[m_index] |= ENTITY_ACTIVE; }
+        void deactivate() { m_pool->m_flags[m_index] &= ~ENTITY_ACTIVE; }
+
+        // ————— GETTERS ————— //
+        int          const get_index()         const { return m_index; }
+        glm::vec3    const get_position()      const { return glm::vec3(m_pool->m_x[m_index], m_pool->m_y[m_index], 0.0f); }
+        glm::vec3    const get_velocity()      const { return glm::vec3(m_pool->m_velocity_x[m_index], m_pool->m_velocity_y[m_index], 0.0f); }
+        float        const get_width()         const { return m_pool->m_half_width[m_index] * 2.0f; }
+        float        const get_height()        const { return m_pool->m_half_height[m_index] * 2.0f; }
+        const AtlasSprite& get_sprite()        const { return m_pool->m_sprite[m_index]; }
+        bool         const is_active()         const { return m_pool->m_flags[m_index] & ENTITY_ACTIVE; }
+        PlatformType const get_platform_type() const { return (m_pool->m_flags[m_index] & ENTITY_TRAP) ? TRAP : NORMAL; }
+
+        // ————— SETTERS ————— //
+        void set_position(glm::vec3 new_position) { m_pool->m_x[m_index] = new_position.x; m_pool->m_y[m_index] = new_position.y; }
+        void set_velocity(glm::vec3 new_velocity) { m_pool->m_velocity_x[m_index] = new_velocity.x; m_pool->m_velocity_y[m_index] = new_velocity.y; }
+        void set_width(float new_width)           { m_pool->m_half_width[m_index] = new_width / 2.0f; }
+        void set_height(float new_height)         { m_pool->m_half_height[m_index] = new_height / 2.0f; }
+        void set_sprite(const AtlasSprite& new_sprite)   { m_pool->m_sprite[m_index] = new_sprite; }
+        void scale(glm::vec3 new_scale)           { m_pool->m_scale[m_index] *= new_scale; }
+        void set_platform_type(PlatformType new_platform_type)
+        {
+            if (new_platform_type == TRAP) { m_pool->m_flags[m_index] |= ENTITY_TRAP; }
+            else                           { m_pool->m_flags[m_index] &= ~ENTITY_TRAP; }
+        }
+    };
+
+    // ————— METHODS ————— //
+    EntityPool(int count = 0);
+
+    void resize(int count);
+    int  add();
+
+    Handle operator[](int index) { return Handle(this, index); }
+
+    void render(SpriteBatch* batch) const;         // defined in EntityRender.cpp
+    void add_instances(InstancedQuads* quads) const;   // static layout for instanced drawing; EntityRender.cpp
+
+    // ————— GETTERS ————— //
+    int const size() const { return (int) m_x.size(); }
+
+    const float*         get_x()           const { return m_x.data(); }
+    const float*         get_y()           const { return m_y.data(); }
+    const float*         get_half_width()  const { return m_half_width.data(); }
+    const float*         get_half_height() const { return m_half_height.data(); }
+    const unsigned char* get_flags()       const { return m_flags.data(); }
+};
+
+#endif // ENTITY_POOL_H
@@ -0,0 +1,44 @@
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "SpriteBatch.h"
+#include "InstancedQuads.h"
+#include "Entity.h"
+#include "EntityPool.h"
+#include "Profiler.h"
+
+// Render half of Entity and EntityPool. It lives apart from the physics so that
+// lunar_sim builds without SDL or GL.
+
+void Entity::render(SpriteBatch* batch, float alpha) const
+{
+    PROFILE_ZONE("Entity::render");
+    // Shift the last step's transform back towards the previous step by (1 - alpha)
+    glm::vec3 offset = (m_previous_position - m_position) * (1.0f - alpha);
+    batch->draw(m_sprite, glm::translate(glm::mat4(1.0f), offset) * m_model_matrix);
+}
+
+void EntityPool::render(SpriteBatch* batch) const
+{
+    PROFILE_ZONE("EntityPool::render");
+    for (int i = 0; i < size(); i++)
+    {
+        batch->draw(m_sprite[i], m_x[i], m_y[i], m_scale[i].x, m_scale[i].y);
+    }
+}
+
+void EntityPool::add_instances(InstancedQuads* quads) const
+{
+    for (int i = 0; i < size(); i++)
+    {
+        quads->add(m_sprite[i], m_x[i], m_y[i], m_scale[i].x, m_scale[i].y);
+    }
+}
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "FramePacer.h"
+
+#ifdef _WINDOWS
+#include <windows.h>
+#else
+#include <cerrno>
+#include <ctime>
+#endif
+
+uint64_t pacer_now_ns()
+{
+    return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t thread_cpu_ns()
+{
+#ifdef _WINDOWS
+    FILETIME creation, exit, kernel, user;
+    GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+    uint64_t ticks = ((uint64_t) kernel.dwHighDateTime << 32 | kernel.dwLowDateTime)
+                   + ((uint64_t) user.dwHighDateTime << 32 | user.dwLowDateTime);
+    return ticks * 100;   // 100 ns ticks
+#else
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+#endif
+}
+
+static void sleep_ns(uint64_t duration_ns)
+{
+#ifdef _WINDOWS
+    std::this_thread::sleep_for(std::chrono::nanoseconds(duration_ns));
+#else
+    timespec remaining { (time_t) (duration_ns / 1000000000ull), (long) (duration_ns % 1000000000ull) };
+    while (nanosleep(&remaining, &remaining) == -1 && errno == EINTR) {}
+#endif
+}
+
+FramePacer::FramePacer(float target_fps)
+{
+    set_target_fps(target_fps);
+}
+
+void FramePacer::set_target_fps(float target_fps)
+{
+    m_period_ns = target_fps > 0.0f ? (uint64_t) (1e9 / target_fps) : 0;
+    m_deadline_ns = 0;
+}
+
+float const FramePacer::get_target_fps() const
+{
+    return m_period_ns > 0 ? (float) (1e9 / m_period_ns) : 0.0f;
+}
+
+void FramePacer::wait()
+{
+    uint64_t now = pacer_now_ns();
+    uint64_t busy_ns = m_last_wake_ns > 0 ? now - m_last_wake_ns : 0;
+    uint64_t late_ns = 0;
+
+    if (m_period_ns > 0)
+    {
+        // First frame, or more than a period behind: start the schedule over from here
+        if (m_deadline_ns == 0 || now > m_deadline_ns + m_period_ns) { m_deadline_ns = now; }
+        m_deadline_ns += m_period_ns;
+
+        uint64_t sleep_until = m_deadline_ns - m_spin_ns;
+        if (now < sleep_until)
+        {
+            sleep_ns(sleep_until - now);
+
+            // Spin for twice the running average of what the sleep overshoots by
+            uint64_t woke = pacer_now_ns();
+            uint64_t oversleep_ns = woke > sleep_until ? woke - sleep_until : 0;
+            m_oversleep_ns = (m_oversleep_ns * 7 + oversleep_ns) / 8;
+            m_spin_ns = std::min(std::max(m_oversleep_ns * 2, MIN_SPIN_NS), MAX_SPIN_NS);
+        }
+
+        // The last stretch: yielding keeps the core available to anything else runnable
+        while ((now = pacer_now_ns()) < m_deadline_ns) { std::this_thread::yield(); }
+        late_ns = now - m_deadline_ns;
+    }
+
+    uint64_t wake = pacer_now_ns();
+    uint64_t wake_cpu = thread_cpu_ns();
+
+    if (m_last_wake_ns > 0)
+    {
+        m_frames++;
+        m_frame_ns += wake - m_last_wake_ns;
+        m_busy_ns += busy_ns;
+        m_cpu_ns += wake_cpu - m_last_wake_cpu_ns;
+        m_max_late_ns = std::max(m_max_late_ns, late_ns);
+    }
+
+    m_last_wake_ns = wake;
+    m_last_wake_cpu_ns = wake_cpu;
+}
+
+FramePacerStats const FramePacer::get_stats() const
+{
+    FramePacerStats stats;
+    stats.frames = m_frames;
+    if (m_frames == 0) { return stats; }
+
+    stats.average_frame_ms = m_frame_ns * 1e-6 / m_frames;
+    stats.average_busy_ms = m_busy_ns * 1e-6 / m_frames;
+    stats.average_cpu_ms = m_cpu_ns * 1e-6 / m_frames;
+    stats.max_late_ms = m_max_late_ns * 1e-6;
+    return stats;
+}
+
+void FramePacer::reset_stats()
+{
+    m_frames = 0;
+    m_frame_ns = 0;
+    m_busy_ns = 0;
+    m_cpu_ns = 0;
+    m_max_late_ns = 0;
+}
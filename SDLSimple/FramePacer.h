@@ -0,0 +1,72 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <cstdint>
+
+// Everything since the last reset_stats(); times are per frame
+struct FramePacerStats
+{
+    int frames = 0;
+    double average_frame_ms = 0.0;  // wake to wake
+    double average_busy_ms = 0.0;   // wake to the next wait(): the frame's own work
+    double average_cpu_ms = 0.0;    // calling thread's CPU time, the final spin included
+    double max_late_ms = 0.0;       // worst wake-up past its deadline
+};
+
+/**
+ * Caps a loop at a target rate without burning the core in between. wait()
+ * puts the thread to sleep with nanosleep until shortly before the next
+ * deadline, then spins (yielding) for the rest, since a plain sleep can
+ * overshoot by a millisecond or more. The spin margin follows the overshoot
+ * the OS actually delivers, so on a quiet machine it stays in the tens of
+ * microseconds.
+ *
+ * Deadlines advance by one period per frame, so an occasional slow frame is
+ * made up by the following ones; a frame more than a whole period late starts
+ * the schedule over instead of rushing to catch up.
+ *
+ *   FramePacer pacer(60.0f);
+ *   while (running) { do_frame(); pacer.wait(); }
+ */
+class FramePacer
+{
+public:
+    static constexpr uint64_t MIN_SPIN_NS = 50000;
+    static constexpr uint64_t MAX_SPIN_NS = 2000000;
+
+private:
+    uint64_t m_period_ns = 0;       // 0: unpaced, wait() only records stats
+    uint64_t m_deadline_ns = 0;
+    uint64_t m_spin_ns = MAX_SPIN_NS;   // how early the sleep ends, in front of the deadline
+    uint64_t m_oversleep_ns = MAX_SPIN_NS / 2;
+
+    uint64_t m_last_wake_ns = 0;
+    uint64_t m_last_wake_cpu_ns = 0;
+
+    int m_frames = 0;
+    uint64_t m_frame_ns = 0;
+    uint64_t m_busy_ns = 0;
+    uint64_t m_cpu_ns = 0;
+    uint64_t m_max_late_ns = 0;
+
+public:
+    explicit FramePacer(float target_fps = 60.0f);
+
+    // 0 turns pacing off
+    void set_target_fps(float target_fps);
+    float const get_target_fps() const;
+
+    // Blocks until the next frame is due; call once per loop iteration, after the frame's work
+    void wait();
+
+    FramePacerStats const get_stats() const;
+    void reset_stats();
+};
+
+// Steady-clock nanoseconds, the clock FramePacer schedules on
+uint64_t pacer_now_ns();
+
+// CPU time the calling thread has used
+uint64_t thread_cpu_ns();
+
+#endif // FRAME_PACER_H
@@ -0,0 +1,132 @@
+#define GL_SILENCE_DEPRECATION
+
+#include <cstring>
+#include "GLStateCache.h"
+
+GLStateCache& GLStateCache::get()
+{
+    static GLStateCache cache;
+    return cache;
+}
+
+void GLStateCache::use_program(GLuint program)
+{
+    if (program == m_program) { m_skipped++; return; }
+
+    glUseProgram(program);
+    m_program = program;
+    m_issued++;
+}
+
+void GLStateCache::bind_texture(int unit, GLuint texture_id)
+{
+    if (unit < 0 || unit >= MAX_TRACKED_TEXTURE_UNITS)
+    {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, texture_id);
+        m_active_unit = (GLuint) unit;
+        m_issued += 2;
+        return;
+    }
+
+    if (texture_id == m_textures[unit]) { m_skipped++; return; }
+
+    if ((GLuint) unit != m_active_unit)
+    {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        m_active_unit = (GLuint) unit;
+        m_issued++;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    m_textures[unit] = texture_id;
+    m_issued++;
+}
+
+void GLStateCache::bind_array_buffer(GLuint buffer)
+{
+    if (buffer == m_array_buffer) { m_skipped++; return; }
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    m_array_buffer = buffer;
+    m_issued++;
+}
+
+void GLStateCache::enable_vertex_attribute(GLuint index)
+{
+    if (index >= 32) { glEnableVertexAttribArray(index); m_issued++; return; }
+
+    unsigned int bit = 1u << index;
+    if ((m_known_attributes & bit) && (m_enabled_attributes & bit)) { m_skipped++; return; }
+
+    glEnableVertexAttribArray(index);
+    m_known_attributes |= bit;
+    m_enabled_attributes |= bit;
+    m_issued++;
+}
+
+void GLStateCache::disable_vertex_attribute(GLuint index)
+{
+    if (index >= 32) { glDisableVertexAttribArray(index); m_issued++; return; }
+
+    unsigned int bit = 1u << index;
+    if ((m_known_attributes & bit) && !(m_enabled_attributes & bit)) { m_skipped++; return; }
+
+    glDisableVertexAttribArray(index);
+    m_known_attributes |= bit;
+    m_enabled_attributes &= ~bit;
+    m_issued++;
+}
+
+bool const GLStateCache::uniform_changed(GLint location, const float* values, int count)
+{
+    unsigned long long key = ((unsigned long long) m_program << 32) | (unsigned int) location;
+
+    auto found = m_uniforms.find(key);
+    if (found != m_uniforms.end() && memcmp(found->second.data(), values, count * sizeof(float)) == 0)
+    {
+        return false;
+    }
+
+    memcpy(m_uniforms[key].data(), values, count * sizeof(float));
+    return true;
+}
+
+void GLStateCache::set_uniform_matrix(GLint location, const glm::mat4& matrix)
+{
+    if (location < 0 || !uniform_changed(location, &matrix[0][0], 16)) { m_skipped++; return; }
+
+    glUniformMatrix4fv(location, 1, GL_FALSE, &matrix[0][0]);
+    m_issued++;
+}
+
+void GLStateCache::set_uniform_vec4(GLint location, float x, float y, float z, float w)
+{
+    float values[] = { x, y, z, w };
+    if (location < 0 || !uniform_changed(location, values, 4)) { m_skipped++; return; }
+
+    glUniform4f(location, x, y, z, w);
+    m_issued++;
+}
+
+void GLStateCache::invalidate()
+{
+    m_program = UNKNOWN_BINDING;
+    m_active_unit = UNKNOWN_BINDING;
+    m_textures.fill(UNKNOWN_BINDING);
+    m_array_buffer = UNKNOWN_BINDING;
+    m_enabled_attributes = 0;
+    m_known_attributes = 0;
+    m_uniforms.clear();
+}
+
+void GLStateCache::forget_program(GLuint program)
+{
+    for (auto it = m_uniforms.begin(); it != m_uniforms.end(); )
+    {
+        if ((GLuint) (it->first >> 32) == program) { it = m_uniforms.erase(it); }
+        else                                       { ++it; }
+    }
+
+    if (program == m_program) { m_program = UNKNOWN_BINDING; }
+}
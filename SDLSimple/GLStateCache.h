@@ -0,0 +1,71 @@
+#ifndef GL_STATE_CACHE_H
+#define GL_STATE_CACHE_H
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <array>
+#include <unordered_map>
+#include "glm/mat4x4.hpp"
+
+constexpr int MAX_TRACKED_TEXTURE_UNITS = 16;
+
+/**
+ * Shadow copy of the GL state the renderer touches: current program, bound
+ * texture per unit, enabled vertex attributes, bound array buffer and the last
+ * value uploaded to each uniform. Every call compares against the shadow
+ * first and only reaches the driver when something actually changes.
+ *
+ * There is one GL context, so there is one cache (GLStateCache::get()). Anything
+ * that changes GL state behind its back must call invalidate() afterwards.
+ */
+class GLStateCache
+{
+private:
+    // UNKNOWN_BINDING means "not seen yet": the next call always reaches the driver
+    static constexpr GLuint UNKNOWN_BINDING = ~0u;
+
+    GLuint m_program = UNKNOWN_BINDING;
+    GLuint m_active_unit = UNKNOWN_BINDING;                    // index, not GL_TEXTUREn
+    std::array<GLuint, MAX_TRACKED_TEXTURE_UNITS> m_textures;
+    GLuint m_array_buffer = UNKNOWN_BINDING;
+    unsigned int m_enabled_attributes = 0;                     // bit per attribute index...
+    unsigned int m_known_attributes = 0;                       // ...valid only where this bit is set
+
+    // Keyed by (program << 32 | location); matrices and vec4s share the 16 floats
+    std::unordered_map<unsigned long long, std::array<float, 16>> m_uniforms;
+
+    long long m_issued = 0;
+    long long m_skipped = 0;
+
+    bool const uniform_changed(GLint location, const float* values, int count);
+
+public:
+    GLStateCache() { invalidate(); }
+
+    static GLStateCache& get();
+
+    void use_program(GLuint program);
+    void bind_texture(int unit, GLuint texture_id);
+    void bind_array_buffer(GLuint buffer);
+    void enable_vertex_attribute(GLuint index);
+    void disable_vertex_attribute(GLuint index);
+
+    // Uploads to the current program, so call use_program first
+    void set_uniform_matrix(GLint location, const glm::mat4& matrix);
+    void set_uniform_vec4(GLint location, float x, float y, float z, float w);
+
+    // Forgets everything: the next call of each kind always reaches the driver
+    void invalidate();
+    // Drops the cached uniforms of a program that has been deleted
+    void forget_program(GLuint program);
+
+    long long const get_issued_count()  const { return m_issued;  }
+    long long const get_skipped_count() const { return m_skipped; }
+    void reset_counters() { m_issued = 0; m_skipped = 0; }
+};
+
+#endif // GL_STATE_CACHE_H
@@ -0,0 +1,124 @@
+#include "GameState.h"
+#include "Profiler.h"
+
+void initialise_game_state(GameState& state, int target_index, int platform_count, glm::vec3 start_position)
+{
+    state.target_index = target_index;
+    state.step = 0;
+    state.game_over = false;
+    state.game_win = false;
+
+    // Platforms never move and their layout depends only on the count, so the
+    // geometry and its broadphase are only rebuilt when the count changes. A new
+    // episode on the same layout then allocates nothing.
+    if (state.platforms.size() != platform_count)
+    {
+        state.platforms.resize(platform_count);
+        for (int i = 0; i < platform_count; i++)
+        {
+            state.platforms[i].set_position(glm::vec3(i - platform_count / 2.0f, -3.0f, 0.0f));
+        }
+
+        state.platform_bvh.build(state.platforms.get_x(), state.platforms.get_y(), state.platforms.get_half_width(),
+                                 state.platforms.get_half_height(), platform_count);
+    }
+
+    for (int i = 0; i < platform_count; i++)
+    {
+        state.platforms[i].set_platform_type(i == target_index ? TRAP : NORMAL);
+        state.platforms[i].activate();
+    }
+
+    AtlasSprite player_sprite = state.player.get_sprite();
+
+    state.player = Entity();
+    state.player.set_position(start_position);
+    state.player.set_movement(glm::vec3(0.0f));
+    state.player.set_acceleration(glm::vec3(0.0f, state.gravity * 0.1, 0.0f));
+    state.player.set_speed(1.0f);
+    state.player.set_sprite(player_sprite);
+    state.player.set_height(0.9f);
+    state.player.set_width(0.9f);
+    state.player.set_collisioin_type(NOCOLLISION);
+    state.player.set_collision_mode(state.collision_mode);
+}
+
+void randomise_game_state(GameState& state, unsigned long long seed, int platform_count)
+{
+    state.rng.reseed(seed);
+
+    int target_index = state.rng.next_int(platform_count);
+    float start_x = state.rng.next_float(-EPISODE_START_X_RANGE, EPISODE_START_X_RANGE);
+    state.gravity = state.rng.next_float(EPISODE_GRAVITY_MIN, EPISODE_GRAVITY_MAX);
+
+    initialise_game_state(state, target_index, platform_count, glm::vec3(start_x, 2.0f, 0.0f));
+}
+
+void seed_game_state(GameState& state, unsigned long long seed, int platform_count)
+{
+    state.rng.reseed(seed);
+    initialise_game_state(state, state.rng.next_int(platform_count), platform_count);
+}
+
+void apply_input(GameState& state, unsigned char input)
+{
+    if (state.game_over) { return; }
+
+    if (input & INPUT_LEFT)
+    {
+        state.player.set_acceleration(glm::vec3(-1.0f, 0.0f, 0.0f));
+    }
+    else if (input & INPUT_RIGHT)
+    {
+        state.player.set_acceleration(glm::vec3(1.0f, 0.0f, 0.0f));
+    }
+    else
+    {
+        state.player.set_acceleration(glm::vec3(0.0f, state.gravity * 0.1, 0.0f));
+    }
+
+    if (input & INPUT_UP)
+    {
+        state.player.set_acceleration(glm::vec3(0.0f, 1.0f + state.gravity * 0.1, 0.0f));
+    }
+    else if (input & INPUT_DOWN)
+    {
+        state.player.set_acceleration(glm::vec3(0.0f, -1.0f - state.gravity * 0.1, 0.0f));
+    }
+}
+
+float const get_altitude(const GameState& state)
+{
+    glm::vec3 position = state.player.get_position();
+    glm::vec3 bottom(position.x, position.y - state.player.get_height() / 2.0f, 0.0f);
+
+    RayHit hit;
+    if (!state.platform_bvh.raycast(bottom, glm::vec3(0.0f, -1.0f, 0.0f), ALTITUDE_RAY_LENGTH, &hit)) { return ALTITUDE_RAY_LENGTH; }
+    return hit.distance;
+}
+
+CollisionType step_game_state(GameState& state, float delta_time)
+{
+    PROFILE_ZONE("step_game_state");
+    state.step++;
+    CollisionType result = NOCOLLISION;
+
+    if (!state.game_over) {
+        result = state.player.update(delta_time, &state.platforms, &state.platform_bvh);
+    }
+
+    if (result == GROUND) {
+        state.game_over = true;
+        state.game_win = false;
+        state.player.set_movement(glm::vec3(0.0f));
+        state.player.deactivate();
+    }
+    else if (result == HITTARGET) {
+        state.game_over = true;
+        state.game_win = true;
+        state.player.set_movement(glm::vec3(0.0f));
+        state.player.deactivate();
+    }
+
+    return result;
+}
@@ -0,0 +1,95 @@
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+#include "Entity.h"
+#include "EntityPool.h"
+#include "StaticBvh.h"
+#include "Rng.h"
+#include <type_traits>
+
+// ————— SIMULATION CONSTANTS ————— //
+constexpr float FIXED_TIMESTEP   = 0.0166666f;
+constexpr int   PLATFORM_COUNT   = 10;
+constexpr float DEFAULT_GRAVITY  = -4.0f;
+constexpr float ALTITUDE_RAY_LENGTH = 100.0f;   // get_altitude's answer when nothing is below
+
+// Ranges randomised episodes draw from
+constexpr float EPISODE_START_X_RANGE = 4.0f;
+constexpr float EPISODE_GRAVITY_MIN   = -6.0f;
+constexpr float EPISODE_GRAVITY_MAX   = -2.0f;
+
+// One bit per control, so a frame's input fits in a byte (scripts, replays)
+enum InputFlag : unsigned char
+{
+    INPUT_LEFT  = 1 << 0,
+    INPUT_RIGHT = 1 << 1,
+    INPUT_UP    = 1 << 2,
+    INPUT_DOWN  = 1 << 3
+};
+
+/**
+ * The part of the simulation that changes while it runs. It is trivially
+ * copyable, so a snapshot or a restore is a single memcpy-sized copy with no
+ * allocation: that is what rewind and instant restart are built on.
+ */
+struct SimState
+{
+    Entity player;
+
+    float gravity = DEFAULT_GRAVITY;
+    int target_index = 0;
+    CollisionMode collision_mode = DISCRETE;
+
+    // Per-episode random stream; nothing in the simulation touches rand()
+    Rng rng;
+
+    bool game_over = false;
+    bool game_win = false;
+
+    float time_accumulator = 0.0f;   // frame time not yet simulated (windowed game)
+    unsigned int step = 0;           // fixed steps since the level was laid out
+};
+
+static_assert(std::is_trivially_copyable<SimState>::value, "SimState snapshots are copied as raw bytes");
+
+/**
+ * Everything the lander simulation needs to step, with no SDL or GL in sight.
+ * The windowed game and lunar_headless both drive it through
+ * initialise_game_state, apply_input and step_game_state.
+ *
+ * Platforms and their broadphase are the level's static geometry: they are
+ * laid out once per level and never snapshotted.
+ */
+struct GameState : SimState
+{
+    EntityPool platforms;
+    StaticBvh platform_bvh;
+};
+
+// Lays out `platform_count` platforms with the target at `target_index` and
+// puts the lander back at its start position
+void initialise_game_state(GameState& state, int target_index, int platform_count = PLATFORM_COUNT,
+                           glm::vec3 start_position = glm::vec3(0.0f, 2.0f, 0.0f));
+
+// Seeds the state's own Rng and draws the target platform, start x and gravity from it
+void randomise_game_state(GameState& state, unsigned long long seed, int platform_count = PLATFORM_COUNT);
+
+// Seeds the state's own Rng and draws only the target platform from it: the
+// windowed game's level, reproducible from the seed an InputRecording stores
+void seed_game_state(GameState& state, unsigned long long seed, int platform_count = PLATFORM_COUNT);
+
+// Copies the dynamic state out of / back into a GameState. Restoring only
+// makes sense within the level the snapshot was taken in.
+inline void snapshot_game_state(const GameState& state, SimState& snapshot) { snapshot = state; }
+inline void restore_game_state(GameState& state, const SimState& snapshot) { static_cast<SimState&>(state) = snapshot; }
+
+// Sets the lander's thrust for the next step from an InputFlag mask
+void apply_input(GameState& state, unsigned char input);
+
+// Distance from the bottom of the lander straight down to the nearest platform top
+float const get_altitude(const GameState& state);
+
+// Advances one fixed step. Returns GROUND or HITTARGET on the step the lander touches down.
+CollisionType step_game_state(GameState& state, float delta_time = FIXED_TIMESTEP);
+
+#endif // GAME_STATE_H
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+#include "GoldenImage.h"
+
+constexpr int MAX_STORED_BLOCK = 65535;
+
+static uint32_t crc32(const unsigned char* data, size_t size, uint32_t crc = 0)
+{
+    static uint32_t table[256];
+    static bool table_ready = false;
+    if (!table_ready)
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++) { value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1; }
+            table[i] = value;
+        }
+        table_ready = true;
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) { crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8); }
+    return ~crc;
+}
+
+static void put_u32(std::vector<unsigned char>& out, uint32_t value)
+{
+    out.push_back((unsigned char) (value >> 24));
+    out.push_back((unsigned char) (value >> 16));
+    out.push_back((unsigned char) (value >> 8));
+    out.push_back((unsigned char) value);
+}
+
+static void put_chunk(std::vector<unsigned char>& out, const char type[4], const std::vector<unsigned char>& data)
+{
+    put_u32(out, (uint32_t) data.size());
+    size_t type_start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    put_u32(out, crc32(out.data() + type_start, out.size() - type_start));
+}
+
+bool write_png(const char* filepath, const unsigned char* rgba, int width, int height)
+{
+    // Scanlines, each behind a "no filter" byte
+    size_t row_bytes = (size_t) width * 4;
+    std::vector<unsigned char> raw;
+    raw.reserve((row_bytes + 1) * height);
+    for (int y = 0; y < height; y++)
+    {
+        raw.push_back(0);
+        raw.insert(raw.end(), rgba + y * row_bytes, rgba + (y + 1) * row_bytes);
+    }
+
+    // zlib stream of stored blocks, then the Adler-32 of the raw bytes
+    std::vector<unsigned char> zlib = { 0x78, 0x01 };
+    size_t offset = 0;
+    do
+    {
+        size_t size = std::min(raw.size() - offset, (size_t) MAX_STORED_BLOCK);
+        bool last = offset + size == raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back((unsigned char) size);
+        zlib.push_back((unsigned char) (size >> 8));
+        zlib.push_back((unsigned char) ~size);
+        zlib.push_back((unsigned char) (~size >> 8));
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + size);
+        offset += size;
+    } while (offset < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (unsigned char byte : raw) { a = (a + byte) % 65521; b = (b + a) % 65521; }
+    put_u32(zlib, b << 16 | a);
+
+    std::vector<unsigned char> header;
+    put_u32(header, (uint32_t) width);
+    put_u32(header, (uint32_t) height);
+    header.insert(header.end(), { 8, 6, 0, 0, 0 });   // 8-bit RGBA, deflate, no filter set, no interlace
+
+    std::vector<unsigned char> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    put_chunk(png, "IHDR", header);
+    put_chunk(png, "IDAT", zlib);
+    put_chunk(png, "IEND", {});
+
+    std::ofstream file(filepath, std::ios::binary);
+    file.write((const char*) png.data(), png.size());
+    return (bool) file;
+}
+
+ImageDifference const compare_images(const unsigned char* a, const unsigned char* b, int width, int height, int tolerance)
+{
+    ImageDifference difference;
+    for (int pixel = 0; pixel < width * height; pixel++)
+    {
+        int pixel_max = 0;
+        for (int channel = 0; channel < 4; channel++)
+        {
+            pixel_max = std::max(pixel_max, abs(a[pixel * 4 + channel] - b[pixel * 4 + channel]));
+        }
+
+        difference.max_channel_difference = std::max(difference.max_channel_difference, pixel_max);
+        if (pixel_max > tolerance) { difference.differing_pixels++; }
+    }
+    return difference;
+}
@@ -0,0 +1,23 @@
+#ifndef GOLDEN_IMAGE_H
+#define GOLDEN_IMAGE_H
+
+/**
+ * Golden-image checks for frames read back from an offscreen render. Images
+ * are RGBA8, top row first, as decode_image_file returns them.
+ *
+ * write_png stores the pixels uncompressed (zlib stored blocks), which keeps
+ * the writer tiny and the output byte-for-byte reproducible; goldens are
+ * small enough that the size does not matter.
+ */
+struct ImageDifference
+{
+    int differing_pixels = 0;       // pixels with any channel off by more than the tolerance
+    int max_channel_difference = 0;
+};
+
+bool write_png(const char* filepath, const unsigned char* rgba, int width, int height);
+
+// Per-channel comparison; `tolerance` absorbs rounding differences between GL drivers
+ImageDifference const compare_images(const unsigned char* a, const unsigned char* b, int width, int height, int tolerance);
+
+#endif // GOLDEN_IMAGE_H
@@ -0,0 +1,68 @@
+#define STB_IMAGE_IMPLEMENTATION
+
+#include <fstream>
+#include <iterator>
+#include "stb_image.h"
+#include "ImageDecodeQueue.h"
+
+bool decode_image_file(const char* filepath, DecodedImage& image)
+{
+    std::ifstream infile(filepath, std::ios::binary);
+    if (infile.fail()) { return false; }
+
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+
+    int number_of_components;
+    image.pixels = stbi_load_from_memory(bytes.data(), (int) bytes.size(), &image.width, &image.height,
+                                         &number_of_components, STBI_rgb_alpha);
+    return image.pixels != nullptr;
+}
+
+void free_decoded_image(DecodedImage& image)
+{
+    stbi_image_free(image.pixels);
+    image.pixels = nullptr;
+}
+
+ImageDecodeQueue::~ImageDecodeQueue()
+{
+    // Outstanding tasks still point at this queue
+    m_pool.wait();
+
+    for (DecodedImage& image : m_finished) { free_decoded_image(image); }
+}
+
+int ImageDecodeQueue::request(const char* filepath)
+{
+    int slot = m_requested++;
+    std::string path = filepath;
+
+    m_pool.submit([this, slot, path]
+    {
+        DecodedImage image;
+        image.slot = slot;
+        decode_image_file(path.c_str(), image);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_finished.push_back(image);
+        }
+        m_ready.notify_one();
+    });
+
+    return slot;
+}
+
+bool ImageDecodeQueue::wait_next(DecodedImage& image)
+{
+    if (m_handed_out == m_requested) { return false; }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_ready.wait(lock, [this] { return !m_finished.empty(); });
+
+    image = m_finished.front();
+    m_finished.pop_front();
+    m_handed_out++;
+
+    return true;
+}
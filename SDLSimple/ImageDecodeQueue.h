@@ -0,0 +1,54 @@
+#ifndef IMAGE_DECODE_QUEUE_H
+#define IMAGE_DECODE_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ThreadPool.h"
+
+// RGBA8 pixels straight out of stb_image; free with free_decoded_image
+struct DecodedImage
+{
+    int slot = -1;              // order the image was requested in
+    int width = 0;
+    int height = 0;
+    unsigned char* pixels = nullptr;
+};
+
+// Reads `filepath` into memory and decodes it to RGBA8. Safe to call from any thread.
+bool decode_image_file(const char* filepath, DecodedImage& image);
+void free_decoded_image(DecodedImage& image);
+
+/**
+ * Decodes image files on a ThreadPool and hands them back one at a time, in
+ * completion order, to whoever calls wait_next (the GL thread). Decoding never
+ * touches GL, so the main thread can upload one texture while the workers are
+ * still decoding the rest.
+ */
+class ImageDecodeQueue
+{
+private:
+    ThreadPool& m_pool;
+
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::deque<DecodedImage> m_finished;
+
+    int m_requested = 0;
+    int m_handed_out = 0;
+
+public:
+    ImageDecodeQueue(ThreadPool& pool) : m_pool(pool) {}
+    ~ImageDecodeQueue();
+
+    // Queues a decode; returns the slot the result will carry
+    int request(const char* filepath);
+
+    // Blocks until the next decode finishes. Returns false once every request
+    // has been handed out. A failed decode comes back with pixels == nullptr.
+    bool wait_next(DecodedImage& image);
+};
+
+#endif // IMAGE_DECODE_QUEUE_H
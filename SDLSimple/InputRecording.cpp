@@ -0,0 +1,67 @@
+#include <cstring>
+#include <fstream>
+#include "InputRecording.h"
+
+constexpr uint32_t MAX_RUN = 0xFFFF;
+
+template <typename T>
+static void write_value(std::ofstream& outfile, T value) { outfile.write((const char*) &value, sizeof(T)); }
+
+template <typename T>
+static bool read_value(std::ifstream& infile, T& value) { return (bool) infile.read((char*) &value, sizeof(T)); }
+
+bool save_input_recording(const InputRecording& recording, const char* filepath)
+{
+    std::ofstream outfile(filepath, std::ios::binary);
+    if (outfile.fail()) { return false; }
+
+    outfile.write(INPUT_RECORDING_MAGIC, sizeof(INPUT_RECORDING_MAGIC));
+    write_value<uint32_t>(outfile, INPUT_RECORDING_VERSION);
+    write_value<uint64_t>(outfile, recording.seed);
+    write_value<float>(outfile, recording.delta_time);
+    write_value<uint32_t>(outfile, (uint32_t) recording.inputs.size());
+
+    size_t step = 0;
+    while (step < recording.inputs.size())
+    {
+        unsigned char input = recording.inputs[step];
+        uint32_t run = 1;
+        while (step + run < recording.inputs.size() && recording.inputs[step + run] == input && run < MAX_RUN) { run++; }
+
+        write_value<uint8_t>(outfile, input);
+        write_value<uint16_t>(outfile, (uint16_t) run);
+        step += run;
+    }
+
+    return !outfile.fail();
+}
+
+bool load_input_recording(const char* filepath, InputRecording& recording)
+{
+    std::ifstream infile(filepath, std::ios::binary);
+    if (infile.fail()) { return false; }
+
+    char magic[sizeof(INPUT_RECORDING_MAGIC)];
+    uint32_t version, step_count;
+    uint64_t seed;
+    float delta_time;
+
+    if (!infile.read(magic, sizeof(magic)) || memcmp(magic, INPUT_RECORDING_MAGIC, sizeof(magic)) != 0) { return false; }
+    if (!read_value(infile, version) || version != INPUT_RECORDING_VERSION) { return false; }
+    if (!read_value(infile, seed) || !read_value(infile, delta_time) || !read_value(infile, step_count)) { return false; }
+
+    recording.seed = seed;
+    recording.delta_time = delta_time;
+    recording.inputs.clear();
+    recording.inputs.reserve(step_count);
+
+    uint8_t input;
+    uint16_t run;
+    while (recording.inputs.size() < step_count && read_value(infile, input) && read_value(infile, run))
+    {
+        if (run == 0 || recording.inputs.size() + run > step_count) { return false; }
+        recording.inputs.insert(recording.inputs.end(), run, input);
+    }
+
+    return recording.inputs.size() == step_count;
+}
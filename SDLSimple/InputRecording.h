@@ -0,0 +1,36 @@
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * One play session reduced to what the simulation consumed: the seed the level
+ * was laid out from and the InputFlag mask of every fixed step. Feeding both
+ * back through seed_game_state and step_game_state reproduces the session.
+ *
+ * On disk (little-endian):
+ *
+ *   char     magic[4]      "LREC"
+ *   uint32_t version
+ *   uint64_t seed
+ *   float    delta_time    fixed step the session ran at
+ *   uint32_t step_count
+ *   { uint8_t input; uint16_t run; } ...   run-length encoded, run >= 1
+ *
+ * Held keys run for many steps, so a minute of play is usually well under 1 KB.
+ */
+constexpr char     INPUT_RECORDING_MAGIC[4] = { 'L', 'R', 'E', 'C' };
+constexpr uint32_t INPUT_RECORDING_VERSION  = 1;
+
+struct InputRecording
+{
+    unsigned long long seed = 0;
+    float delta_time = 0.0f;
+    std::vector<unsigned char> inputs;   // one InputFlag mask per fixed step
+};
+
+bool save_input_recording(const InputRecording& recording, const char* filepath);
+bool load_input_recording(const char* filepath, InputRecording& recording);
+
+#endif // INPUT_RECORDING_H
@@ -0,0 +1,155 @@
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cstddef>
+#include "InstancedQuads.h"
+#include "ShaderProgram.h"
+#include "GLStateCache.h"
+#include "Profiler.h"
+
+#ifdef __APPLE__
+// The legacy 2.1 context only exposes instancing through the ARB extensions
+#define glDrawArraysInstanced glDrawArraysInstancedARB
+#define glVertexAttribDivisor glVertexAttribDivisorARB
+#endif
+
+// The same two triangles SpriteBatch emits, as (x, y, u, v) over the unit quad
+static const float UNIT_QUAD[] = { -0.5f, -0.5f, 0.0f, 1.0f,    0.5f, -0.5f, 1.0f, 1.0f,    0.5f, 0.5f, 1.0f, 0.0f,
+                                   -0.5f, -0.5f, 0.0f, 1.0f,    0.5f,  0.5f, 1.0f, 0.0f,   -0.5f, 0.5f, 0.0f, 0.0f };
+
+constexpr int VERTICES_PER_QUAD = 6;
+constexpr int FLOATS_PER_VERTEX = 4;
+
+static GLushort const to_unorm16(float value)
+{
+    return (GLushort) (std::min(std::max(value, 0.0f), 1.0f) * 65535.0f + 0.5f);
+}
+
+InstancedQuads::~InstancedQuads()
+{
+    release();
+}
+
+void InstancedQuads::release()
+{
+    if (m_quad_buffer == 0) { return; }
+
+    // Deleting a bound buffer unbinds it, so the cached binding would go stale
+    glDeleteBuffers(1, &m_quad_buffer);
+    glDeleteBuffers(1, &m_instance_buffer);
+    GLStateCache::get().invalidate();
+
+    m_quad_buffer = 0;
+    m_instance_buffer = 0;
+}
+
+void InstancedQuads::clear()
+{
+    m_instances.clear();
+    m_texture_ids.clear();
+    m_runs.clear();
+}
+
+void InstancedQuads::add(const AtlasSprite& sprite, float x, float y, float width, float height)
+{
+    Instance instance;
+    instance.x = x;
+    instance.y = y;
+    instance.width = width;
+    instance.height = height;
+    instance.uv_rect[0] = to_unorm16(sprite.uv_rect.x);
+    instance.uv_rect[1] = to_unorm16(sprite.uv_rect.y);
+    instance.uv_rect[2] = to_unorm16(sprite.uv_rect.z);
+    instance.uv_rect[3] = to_unorm16(sprite.uv_rect.w);
+
+    m_instances.push_back(instance);
+    m_texture_ids.push_back(sprite.page_texture_id);
+}
+
+void InstancedQuads::upload()
+{
+    GLStateCache& state = GLStateCache::get();
+
+    if (m_quad_buffer == 0)
+    {
+        glGenBuffers(1, &m_quad_buffer);
+        glGenBuffers(1, &m_instance_buffer);
+
+        state.bind_array_buffer(m_quad_buffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(UNIT_QUAD), UNIT_QUAD, GL_STATIC_DRAW);
+    }
+
+    // Group by page; stable so instances on one page keep the order they were added in
+    std::vector<int> order(m_instances.size());
+    for (int i = 0; i < (int) order.size(); i++) { order[i] = i; }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return m_texture_ids[a] < m_texture_ids[b]; });
+
+    std::vector<Instance> sorted(m_instances.size());
+    std::vector<GLuint> sorted_texture_ids(m_instances.size());
+    for (int i = 0; i < (int) order.size(); i++)
+    {
+        sorted[i] = m_instances[order[i]];
+        sorted_texture_ids[i] = m_texture_ids[order[i]];
+    }
+    m_instances.swap(sorted);
+    m_texture_ids.swap(sorted_texture_ids);
+
+    m_runs.clear();
+    for (int i = 0; i < (int) m_instances.size(); i++)
+    {
+        if (m_runs.empty() || m_runs.back().texture_id != m_texture_ids[i]) { m_runs.push_back(Run { m_texture_ids[i], i, 0 }); }
+        m_runs.back().count++;
+    }
+
+    state.bind_array_buffer(m_instance_buffer);
+    glBufferData(GL_ARRAY_BUFFER, m_instances.size() * sizeof(Instance), m_instances.data(), GL_STATIC_DRAW);
+}
+
+void InstancedQuads::draw(ShaderProgram* program)
+{
+    m_draw_calls = 0;
+    if (m_runs.empty()) { return; }
+
+    PROFILE_ZONE("InstancedQuads::draw");
+
+    GLStateCache& state = GLStateCache::get();
+    GLuint position  = program->get_position_attribute();
+    GLuint tex_coord = program->get_tex_coordinate_attribute();
+    GLuint transform = program->get_instance_transform_attribute();
+    GLuint uv_rect   = program->get_instance_uv_attribute();
+
+    program->set_model_matrix(glm::mat4(1.0f));
+
+    state.bind_array_buffer(m_quad_buffer);
+    GLsizei stride = FLOATS_PER_VERTEX * sizeof(float);
+    glVertexAttribPointer(position, 2, GL_FLOAT, false, stride, (void*) 0);
+    state.enable_vertex_attribute(position);
+    glVertexAttribPointer(tex_coord, 2, GL_FLOAT, false, stride, (void*) (2 * sizeof(float)));
+    state.enable_vertex_attribute(tex_coord);
+
+    state.bind_array_buffer(m_instance_buffer);
+    state.enable_vertex_attribute(transform);
+    state.enable_vertex_attribute(uv_rect);
+    glVertexAttribDivisor(transform, 1);
+    glVertexAttribDivisor(uv_rect, 1);
+
+    for (const Run& run : m_runs)
+    {
+        // No base-instance draw in this GL, so each page's run is reached by offsetting the pointers
+        size_t offset = run.first * sizeof(Instance);
+        glVertexAttribPointer(transform, 4, GL_FLOAT, false, sizeof(Instance), (void*) offset);
+        glVertexAttribPointer(uv_rect, 4, GL_UNSIGNED_SHORT, true, sizeof(Instance),
+                              (void*) (offset + offsetof(Instance, uv_rect)));
+
+        state.bind_texture(0, run.texture_id);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, VERTICES_PER_QUAD, run.count);
+        m_draw_calls++;
+    }
+
+    // Divisors are per attribute slot, not per program: put them back so a
+    // SpriteBatch program that lands on the same slots reads per vertex again
+    glVertexAttribDivisor(transform, 0);
+    glVertexAttribDivisor(uv_rect, 0);
+    state.disable_vertex_attribute(transform);
+    state.disable_vertex_attribute(uv_rect);
+}
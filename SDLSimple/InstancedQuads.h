@@ -0,0 +1,79 @@
+#ifndef INSTANCED_QUADS_H
+#define INSTANCED_QUADS_H
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "TextureAtlas.h"
+
+class ShaderProgram;
+
+/**
+ * Static field of axis-aligned sprites drawn with instancing, for geometry that
+ * is laid out once and then only drawn: terrain tiles, backgrounds.
+ *
+ * One shared VBO holds the unit quad. Each sprite is one 24-byte instance,
+ * (x, y, width, height) as floats plus its atlas rect as normalised shorts,
+ * and the vertex shader (shaders/vertex_textured_instanced.glsl) builds the
+ * corners from it. Instances are uploaded once by upload(); after that a frame
+ * costs one glDrawArraysInstanced per atlas page and no vertex traffic at all,
+ * where SpriteBatch streams 96 bytes per sprite every frame.
+ *
+ * Draw it with a program loaded from the instanced shader, then switch back
+ * before using SpriteBatch.
+ */
+class InstancedQuads
+{
+private:
+    struct Instance
+    {
+        float x, y, width, height;
+        GLushort uv_rect[4];        // u0, v0, u1, v1 in 0..65535
+    };
+
+    struct Run
+    {
+        GLuint texture_id;
+        int first, count;           // range of m_instances on this atlas page
+    };
+
+    GLuint m_quad_buffer = 0;
+    GLuint m_instance_buffer = 0;
+
+    std::vector<Instance> m_instances;
+    std::vector<GLuint> m_texture_ids;  // per instance until upload() groups them into runs
+    std::vector<Run> m_runs;
+
+    int m_draw_calls = 0;
+
+public:
+    InstancedQuads() = default;
+    ~InstancedQuads();
+
+    InstancedQuads(const InstancedQuads&) = delete;
+    InstancedQuads& operator=(const InstancedQuads&) = delete;
+
+    void clear();
+
+    // Deletes the GL buffers; call before the context goes away (see SpriteBatch::release)
+    void release();
+
+    // Queues an axis-aligned sprite centred on (x, y); nothing is drawn until upload()
+    void add(const AtlasSprite& sprite, float x, float y, float width, float height);
+
+    // Groups instances by atlas page and copies them to the GPU. Needs a current GL context.
+    void upload();
+
+    // One instanced draw per atlas page, with `program` loaded from the instanced shader
+    void draw(ShaderProgram* program);
+
+    int const get_instance_count()   const { return (int) m_instances.size(); }
+    int const get_draw_call_count()  const { return m_draw_calls; }
+    int const get_bytes_per_sprite() const { return (int) sizeof(Instance); }
+};
+
+#endif // INSTANCED_QUADS_H
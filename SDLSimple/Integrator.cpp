@@ -0,0 +1,118 @@
+// Only this translation unit asks glm for intrinsics, so the rest of the build
+// keeps its current glm configuration
+#define GLM_FORCE_INTRINSICS
+#include "glm/simd/platform.h"
+#include <cmath>
+#include "Integrator.h"
+
+// Bodies [first, count) one at a time; the vector paths finish their tail here
+static void integrate_scalar(float* x, float* y, float* velocity_x, float* velocity_y,
+                             const float* acceleration_x, const float* acceleration_y,
+                             int first, int count, float delta_time, float max_speed)
+{
+    for (int i = first; i < count; i++)
+    {
+        float vx = velocity_x[i] + acceleration_x[i] * delta_time;
+        float vy = velocity_y[i] + acceleration_y[i] * delta_time;
+
+        float length = sqrtf(vx * vx + vy * vy);
+        if (length > max_speed)
+        {
+            vx *= max_speed / length;
+            vy *= max_speed / length;
+        }
+
+        velocity_x[i] = vx;
+        velocity_y[i] = vy;
+        x[i] += vx * delta_time;
+        y[i] += vy * delta_time;
+    }
+}
+
+#if GLM_ARCH & GLM_ARCH_AVX_BIT
+
+void integrate_bodies(float* x, float* y, float* velocity_x, float* velocity_y,
+                      const float* acceleration_x, const float* acceleration_y,
+                      int count, float delta_time, float max_speed)
+{
+    const __m256 dt = _mm256_set1_ps(delta_time);
+    const __m256 limit = _mm256_set1_ps(max_speed);
+    const __m256 limit_squared = _mm256_set1_ps(max_speed * max_speed);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 three_halves = _mm256_set1_ps(1.5f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 vx = _mm256_add_ps(_mm256_loadu_ps(velocity_x + i), _mm256_mul_ps(_mm256_loadu_ps(acceleration_x + i), dt));
+        __m256 vy = _mm256_add_ps(_mm256_loadu_ps(velocity_y + i), _mm256_mul_ps(_mm256_loadu_ps(acceleration_y + i), dt));
+
+        // 1 / length from the ~12-bit estimate, refined once: r' = r * (1.5 - 0.5 * len² * r²)
+        __m256 length_squared = _mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy));
+        __m256 r = _mm256_rsqrt_ps(length_squared);
+        r = _mm256_mul_ps(r, _mm256_sub_ps(three_halves, _mm256_mul_ps(_mm256_mul_ps(half, length_squared), _mm256_mul_ps(r, r))));
+
+        // Lanes under the limit keep a scale of 1, which also keeps 0 * inf out of still bodies
+        __m256 too_fast = _mm256_cmp_ps(length_squared, limit_squared, _CMP_GT_OQ);
+        __m256 scale = _mm256_blendv_ps(one, _mm256_mul_ps(limit, r), too_fast);
+        vx = _mm256_mul_ps(vx, scale);
+        vy = _mm256_mul_ps(vy, scale);
+
+        _mm256_storeu_ps(velocity_x + i, vx);
+        _mm256_storeu_ps(velocity_y + i, vy);
+        _mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(vx, dt)));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(vy, dt)));
+    }
+
+    integrate_scalar(x, y, velocity_x, velocity_y, acceleration_x, acceleration_y, i, count, delta_time, max_speed);
+}
+
+#elif GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+void integrate_bodies(float* x, float* y, float* velocity_x, float* velocity_y,
+                      const float* acceleration_x, const float* acceleration_y,
+                      int count, float delta_time, float max_speed)
+{
+    const __m128 dt = _mm_set1_ps(delta_time);
+    const __m128 limit = _mm_set1_ps(max_speed);
+    const __m128 limit_squared = _mm_set1_ps(max_speed * max_speed);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 three_halves = _mm_set1_ps(1.5f);
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 vx = _mm_add_ps(_mm_loadu_ps(velocity_x + i), _mm_mul_ps(_mm_loadu_ps(acceleration_x + i), dt));
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(velocity_y + i), _mm_mul_ps(_mm_loadu_ps(acceleration_y + i), dt));
+
+        __m128 length_squared = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+        __m128 r = _mm_rsqrt_ps(length_squared);
+        r = _mm_mul_ps(r, _mm_sub_ps(three_halves, _mm_mul_ps(_mm_mul_ps(half, length_squared), _mm_mul_ps(r, r))));
+
+        // SSE2 has no blend: select with and / andnot
+        __m128 too_fast = _mm_cmpgt_ps(length_squared, limit_squared);
+        __m128 scale = _mm_or_ps(_mm_and_ps(too_fast, _mm_mul_ps(limit, r)), _mm_andnot_ps(too_fast, one));
+        vx = _mm_mul_ps(vx, scale);
+        vy = _mm_mul_ps(vy, scale);
+
+        _mm_storeu_ps(velocity_x + i, vx);
+        _mm_storeu_ps(velocity_y + i, vy);
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(vx, dt)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(vy, dt)));
+    }
+
+    integrate_scalar(x, y, velocity_x, velocity_y, acceleration_x, acceleration_y, i, count, delta_time, max_speed);
+}
+
+#else
+
+void integrate_bodies(float* x, float* y, float* velocity_x, float* velocity_y,
+                      const float* acceleration_x, const float* acceleration_y,
+                      int count, float delta_time, float max_speed)
+{
+    integrate_scalar(x, y, velocity_x, velocity_y, acceleration_x, acceleration_y, 0, count, delta_time, max_speed);
+}
+
+#endif
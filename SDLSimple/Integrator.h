@@ -0,0 +1,22 @@
+#ifndef INTEGRATOR_H
+#define INTEGRATOR_H
+
+/**
+ * Batched explicit Euler step for many bodies stored as separate arrays, the
+ * same step Entity::update takes for one:
+ *
+ *   velocity += acceleration * delta_time
+ *   velocity  = clamped to max_speed in length
+ *   position += velocity * delta_time
+ *
+ * The backend (AVX 8 bodies at a time, SSE2 4 at a time, or plain scalar) is
+ * picked at compile time from glm's simd platform detection, as in AabbBatch.
+ * The vector paths clamp with an rsqrt estimate plus one Newton step instead
+ * of a sqrt and a divide, which agrees with the scalar path to about 1e-6
+ * relative. Arrays need no particular alignment.
+ */
+void integrate_bodies(float* x, float* y, float* velocity_x, float* velocity_y,
+                      const float* acceleration_x, const float* acceleration_y,
+                      int count, float delta_time, float max_speed);
+
+#endif // INTEGRATOR_H
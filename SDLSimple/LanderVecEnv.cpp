@@ -0,0 +1,89 @@
+#include "LanderVecEnv.h"
+
+LanderVecEnv::LanderVecEnv(int env_count, ThreadPool* pool, CollisionMode collision_mode,
+                           int max_steps, int platform_count)
+    : m_envs(env_count), m_episode_steps(env_count, 0), m_pool(pool),
+      m_platform_count(platform_count), m_max_steps(max_steps)
+{
+    for (GameState& state : m_envs)
+    {
+        state.collision_mode = collision_mode;
+
+        // Lays the platforms and broadphase out now, so no episode reset ever has to
+        randomise_game_state(state, 0, m_platform_count);
+    }
+
+    m_step_body = [this](int begin, int end) { step_range(begin, end); };
+}
+
+void LanderVecEnv::observe(int index, float* observation)
+{
+    GameState& state = m_envs[index];
+    glm::vec3 position = state.player.get_position();
+    glm::vec3 velocity = state.player.get_velocity();
+
+    observation[0] = position.x;
+    observation[1] = position.y;
+    observation[2] = velocity.x;
+    observation[3] = velocity.y;
+    observation[4] = state.platforms[state.target_index].get_position().x;
+    observation[5] = get_altitude(state);
+}
+
+void LanderVecEnv::reset(const unsigned long long* seeds, float* observations)
+{
+    for (int i = 0; i < get_env_count(); i++)
+    {
+        randomise_game_state(m_envs[i], seeds[i], m_platform_count);
+        m_episode_steps[i] = 0;
+        observe(i, &observations[i * LANDER_OBSERVATION_SIZE]);
+    }
+}
+
+void LanderVecEnv::step_range(int begin, int end)
+{
+    for (int i = begin; i < end; i++)
+    {
+        GameState& state = m_envs[i];
+
+        apply_input(state, m_actions[i]);
+        CollisionType collision = step_game_state(state);
+        m_episode_steps[i]++;
+
+        m_rewards[i] = collision == HITTARGET ? REWARD_HITTARGET
+                     : collision == GROUND    ? REWARD_GROUND : 0.0f;
+
+        bool done = state.game_over || m_episode_steps[i] >= m_max_steps;
+        m_dones[i] = done ? 1 : 0;
+
+        if (done)
+        {
+            // Next seed comes off this environment's own stream, so a run is reproducible from reset()'s seeds
+            unsigned long long seed = ((unsigned long long) state.rng.next() << 32) | state.rng.next();
+            randomise_game_state(state, seed, m_platform_count);
+            m_episode_steps[i] = 0;
+        }
+
+        observe(i, &m_observations[i * LANDER_OBSERVATION_SIZE]);
+    }
+}
+
+void LanderVecEnv::step(const unsigned char* actions, float* observations, float* rewards, unsigned char* dones)
+{
+    m_actions = actions;
+    m_observations = observations;
+    m_rewards = rewards;
+    m_dones = dones;
+
+    int env_count = get_env_count();
+
+    if (m_pool == nullptr || m_pool->get_thread_count() == 1)
+    {
+        step_range(0, env_count);
+        return;
+    }
+
+    // One contiguous slice per worker: lockstep wants every slice done, not fine-grained balance
+    int slice = (env_count + m_pool->get_thread_count() - 1) / m_pool->get_thread_count();
+    m_pool->parallel_for(env_count, slice, m_step_body);
+}
@@ -0,0 +1,68 @@
+#ifndef LANDER_VEC_ENV_H
+#define LANDER_VEC_ENV_H
+
+#include <functional>
+#include <vector>
+#include "GameState.h"
+#include "ThreadPool.h"
+
+// Per-environment observation: x, y, velocity x, velocity y, target platform x, altitude
+constexpr int LANDER_OBSERVATION_SIZE = 6;
+constexpr int DEFAULT_VEC_ENV_MAX_STEPS = 60 * 60;
+
+constexpr float REWARD_HITTARGET = 1.0f;
+constexpr float REWARD_GROUND    = -1.0f;
+
+/**
+ * K independent landers stepped in lockstep, for training controllers without
+ * a window. Each environment is a full GameState driven through apply_input
+ * and step_game_state, so it lands exactly like the game does.
+ *
+ * All buffers belong to the caller and are contiguous per field:
+ *
+ *   actions       unsigned char[K]                        InputFlag masks
+ *   observations  float[K * LANDER_OBSERVATION_SIZE]
+ *   rewards       float[K]                                 REWARD_* on touchdown, else 0
+ *   dones         unsigned char[K]                         1 on touchdown or after max_steps
+ *
+ * A finished environment resets itself inside the same step() from a seed drawn
+ * off its own Rng, and its observation row is already the new episode's first.
+ * step() allocates nothing; with a pool, environments are split into one
+ * contiguous slice per worker.
+ */
+class LanderVecEnv
+{
+private:
+    std::vector<GameState> m_envs;
+    std::vector<int> m_episode_steps;
+    ThreadPool* m_pool;
+    int m_platform_count;
+    int m_max_steps;
+
+    // step() arguments, read by m_step_body on the workers
+    const unsigned char* m_actions = nullptr;
+    float* m_observations = nullptr;
+    float* m_rewards = nullptr;
+    unsigned char* m_dones = nullptr;
+
+    // Built once so parallel_for never has to wrap a fresh lambda per step
+    std::function<void(int, int)> m_step_body;
+
+    void step_range(int begin, int end);
+    void observe(int index, float* observation);
+
+public:
+    // `pool` may be nullptr to step on the calling thread
+    LanderVecEnv(int env_count, ThreadPool* pool = nullptr, CollisionMode collision_mode = DISCRETE,
+                 int max_steps = DEFAULT_VEC_ENV_MAX_STEPS, int platform_count = PLATFORM_COUNT);
+
+    // Starts a fresh episode in every environment from seeds[K]
+    void reset(const unsigned long long* seeds, float* observations);
+
+    void step(const unsigned char* actions, float* observations, float* rewards, unsigned char* dones);
+
+    int const get_env_count() const { return (int) m_envs.size(); }
+    const GameState& get_env(int index) const { return m_envs[index]; }
+};
+
+#endif // LANDER_VEC_ENV_H
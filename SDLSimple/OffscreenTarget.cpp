@@ -0,0 +1,62 @@
+#define GL_SILENCE_DEPRECATION
+
+#include <cstring>
+#include "OffscreenTarget.h"
+
+OffscreenTarget::~OffscreenTarget()
+{
+    release();
+}
+
+void OffscreenTarget::release()
+{
+    if (m_framebuffer == 0) { return; }
+
+    glDeleteFramebuffers(1, &m_framebuffer);
+    glDeleteRenderbuffers(1, &m_color_buffer);
+
+    m_framebuffer = 0;
+    m_color_buffer = 0;
+}
+
+bool OffscreenTarget::create(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+
+    glGenRenderbuffers(1, &m_color_buffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_color_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_color_buffer);
+
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+void OffscreenTarget::bind() const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+}
+
+void OffscreenTarget::read_pixels(std::vector<unsigned char>& rgba) const
+{
+    size_t row_bytes = (size_t) m_width * 4;
+    rgba.resize(row_bytes * m_height);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+
+    // GL rows start at the bottom
+    std::vector<unsigned char> row(row_bytes);
+    for (int y = 0; y < m_height / 2; y++)
+    {
+        unsigned char* top = rgba.data() + y * row_bytes;
+        unsigned char* bottom = rgba.data() + (m_height - 1 - y) * row_bytes;
+        memcpy(row.data(), top, row_bytes);
+        memcpy(top, bottom, row_bytes);
+        memcpy(bottom, row.data(), row_bytes);
+    }
+}
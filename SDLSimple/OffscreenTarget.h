@@ -0,0 +1,50 @@
+#ifndef OFFSCREEN_TARGET_H
+#define OFFSCREEN_TARGET_H
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+
+/**
+ * Framebuffer object with one RGBA8 colour renderbuffer, for rendering where
+ * there is no window to show: golden-image checks and render benchmarks on
+ * machines with no display (SDL's offscreen video driver, llvmpipe).
+ *
+ * While bound, draws land here instead of the default framebuffer and
+ * read_pixels() copies them back to memory.
+ */
+class OffscreenTarget
+{
+private:
+    GLuint m_framebuffer = 0;
+    GLuint m_color_buffer = 0;
+    int m_width = 0;
+    int m_height = 0;
+
+public:
+    OffscreenTarget() = default;
+    ~OffscreenTarget();
+
+    OffscreenTarget(const OffscreenTarget&) = delete;
+    OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+    // Needs a current GL context. False if the driver cannot render to it.
+    bool create(int width, int height);
+
+    void bind() const;
+
+    // Deletes the FBO and renderbuffer; call before the GL context goes away
+    void release();
+
+    // RGBA8, top row first to match decoded images
+    void read_pixels(std::vector<unsigned char>& rgba) const;
+
+    int const get_width()  const { return m_width; }
+    int const get_height() const { return m_height; }
+};
+
+#endif // OFFSCREEN_TARGET_H
@@ -0,0 +1,158 @@
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Profiler.h"
+
+struct ProfileEvent
+{
+    const char* name;
+    uint64_t start_ns;
+    uint64_t end_ns;
+};
+
+// One per recording thread; only that thread writes, the exporter only reads
+struct ProfileThreadBuffer
+{
+    int thread_index;
+    const char* name = nullptr;
+    std::vector<ProfileEvent> events;
+    std::atomic<uint64_t> count { 0 };
+};
+
+static std::atomic<bool> s_enabled { false };
+
+// Buffers outlive their threads so a trace can still show a finished worker
+static std::mutex s_registry_mutex;
+static std::vector<std::unique_ptr<ProfileThreadBuffer>> s_registry;
+static thread_local ProfileThreadBuffer* s_thread_buffer = nullptr;
+
+static uint64_t s_frame_marks[PROFILER_FRAME_HISTORY];
+static std::atomic<uint64_t> s_frame_count { 0 };
+
+uint64_t profiler_now_ns()
+{
+    return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void profiler_set_enabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+bool profiler_is_enabled()              { return s_enabled.load(std::memory_order_relaxed); }
+
+void profiler_mark_frame()
+{
+    if (!profiler_is_enabled()) { return; }
+
+    uint64_t frame = s_frame_count.load(std::memory_order_relaxed);
+    s_frame_marks[frame % PROFILER_FRAME_HISTORY] = profiler_now_ns();
+    s_frame_count.store(frame + 1, std::memory_order_release);
+}
+
+static ProfileThreadBuffer* thread_buffer()
+{
+    if (s_thread_buffer == nullptr)
+    {
+        // First zone on this thread: the only time recording takes a lock
+        std::lock_guard<std::mutex> lock(s_registry_mutex);
+        s_registry.push_back(std::make_unique<ProfileThreadBuffer>());
+        s_thread_buffer = s_registry.back().get();
+        s_thread_buffer->thread_index = (int) s_registry.size() - 1;
+        s_thread_buffer->events.resize(PROFILER_EVENTS_PER_THREAD);
+    }
+
+    return s_thread_buffer;
+}
+
+ProfileZone::ProfileZone(const char* name) : m_name(name), m_start_ns(0)
+{
+    if (profiler_is_enabled()) { m_start_ns = profiler_now_ns(); }
+}
+
+ProfileZone::~ProfileZone()
+{
+    // Enabled mid-zone: no start time, nothing to record
+    if (m_start_ns == 0 || !profiler_is_enabled()) { return; }
+
+    ProfileThreadBuffer* buffer = thread_buffer();
+    uint64_t count = buffer->count.load(std::memory_order_relaxed);
+
+    buffer->events[count % PROFILER_EVENTS_PER_THREAD] = { m_name, m_start_ns, profiler_now_ns() };
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+void profiler_set_thread_name(const char* name)
+{
+    thread_buffer()->name = name;
+}
+
+static void write_json_string(std::ofstream& outfile, const char* text)
+{
+    outfile << '"';
+    for (const char* c = text; *c != '\0'; c++)
+    {
+        if (*c == '"' || *c == '\\') { outfile << '\\'; }
+        outfile << *c;
+    }
+    outfile << '"';
+}
+
+bool profiler_write_chrome_trace(const char* filepath, int frame_count)
+{
+    std::ofstream outfile(filepath);
+    if (outfile.fail()) { return false; }
+
+    // Cut at the start of the oldest requested frame that is still in the history
+    uint64_t frames = s_frame_count.load(std::memory_order_acquire);
+    uint64_t kept = frames < PROFILER_FRAME_HISTORY ? frames : PROFILER_FRAME_HISTORY;
+    uint64_t wanted = frame_count > 0 && (uint64_t) frame_count < kept ? (uint64_t) frame_count : kept;
+    uint64_t cutoff_ns = wanted > 0 ? s_frame_marks[(frames - wanted) % PROFILER_FRAME_HISTORY] : 0;
+
+    // Chrome trace timestamps are microseconds; make them relative to the cut
+    auto microseconds = [cutoff_ns](uint64_t ns) { return (double) (ns - cutoff_ns) / 1000.0; };
+
+    outfile << std::fixed << std::setprecision(3);
+    outfile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+
+    std::lock_guard<std::mutex> lock(s_registry_mutex);
+    for (const std::unique_ptr<ProfileThreadBuffer>& buffer : s_registry)
+    {
+        std::string name = buffer->name != nullptr ? buffer->name : "thread " + std::to_string(buffer->thread_index);
+
+        outfile << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                << buffer->thread_index << ",\"args\":{\"name\":";
+        write_json_string(outfile, name.c_str());
+        outfile << "}}";
+        first = false;
+
+        uint64_t count = buffer->count.load(std::memory_order_acquire);
+        uint64_t oldest = count > PROFILER_EVENTS_PER_THREAD ? count - PROFILER_EVENTS_PER_THREAD : 0;
+
+        for (uint64_t i = oldest; i < count; i++)
+        {
+            const ProfileEvent& event = buffer->events[i % PROFILER_EVENTS_PER_THREAD];
+            if (event.start_ns < cutoff_ns) { continue; }
+
+            outfile << ",\n{\"name\":";
+            write_json_string(outfile, event.name);
+            outfile << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_index
+                    << ",\"ts\":" << microseconds(event.start_ns)
+                    << ",\"dur\":" << (double) (event.end_ns - event.start_ns) / 1000.0 << "}";
+        }
+    }
+
+    // Frame boundaries as global instant events, so spikes line up with frames
+    for (uint64_t frame = frames - wanted; frame < frames; frame++)
+    {
+        outfile << (first ? "" : ",\n") << "{\"name\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":"
+                << microseconds(s_frame_marks[frame % PROFILER_FRAME_HISTORY]) << "}";
+        first = false;
+    }
+
+    outfile << "\n]}\n";
+    return !outfile.fail();
+}
@@ -0,0 +1,70 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+
+/**
+ * Scoped frame profiler.
+ *
+ *   void update()
+ *   {
+ *       PROFILE_ZONE("update");
+ *       ...
+ *   }
+ *
+ * A zone records its start and end time when it goes out of scope, into a ring
+ * buffer owned by the calling thread, so recording never takes a lock. Zones
+ * nest naturally: an inner zone closes first and sits inside its parent's time
+ * span, which is exactly how the Chrome trace viewer and Perfetto stack them.
+ *
+ * Recording is off until profiler_set_enabled(true); a disabled zone costs one
+ * relaxed atomic load. Building with LUNAR_PROFILING=0 compiles zones out
+ * completely.
+ */
+#ifndef LUNAR_PROFILING
+#define LUNAR_PROFILING 1
+#endif
+
+constexpr int PROFILER_EVENTS_PER_THREAD = 1 << 15;   // oldest events are overwritten
+constexpr int PROFILER_FRAME_HISTORY     = 1024;      // frame marks kept for export
+
+void profiler_set_enabled(bool enabled);
+bool profiler_is_enabled();
+
+// Labels the calling thread's track in exported traces; `name` must outlive the profiler
+void profiler_set_thread_name(const char* name);
+
+// Call once per frame from the main thread; trace export is cut at frame marks
+void profiler_mark_frame();
+
+// Writes every zone recorded during the last `frame_count` frames as Chrome
+// trace_event JSON. Call while no other thread is recording (e.g. at shutdown).
+bool profiler_write_chrome_trace(const char* filepath, int frame_count);
+
+uint64_t profiler_now_ns();
+
+class ProfileZone
+{
+private:
+    const char* m_name;
+    uint64_t m_start_ns;
+
+public:
+    // `name` must outlive the profiler, in practice a string literal
+    explicit ProfileZone(const char* name);
+    ~ProfileZone();
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+};
+
+#define PROFILE_CONCATENATE_(a, b) a##b
+#define PROFILE_CONCATENATE(a, b) PROFILE_CONCATENATE_(a, b)
+
+#if LUNAR_PROFILING
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCATENATE(profile_zone_, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name) ((void) 0)
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,43 @@
+#ifndef RNG_H
+#define RNG_H
+
+/**
+ * Small PCG32 generator. Every episode owns one, so runs are reproducible from
+ * their seed and independent of each other and of the global rand() state.
+ */
+class Rng
+{
+private:
+    unsigned long long m_state = 0;
+    unsigned long long m_increment = 1;
+
+public:
+    Rng(unsigned long long seed = 0, unsigned long long stream = 0) { reseed(seed, stream); }
+
+    void reseed(unsigned long long seed, unsigned long long stream = 0)
+    {
+        m_state = 0;
+        m_increment = (stream << 1) | 1;
+        next();
+        m_state += seed;
+        next();
+    }
+
+    unsigned int next()
+    {
+        unsigned long long old_state = m_state;
+        m_state = old_state * 6364136223846793005ULL + m_increment;
+
+        unsigned int xorshifted = (unsigned int) (((old_state >> 18) ^ old_state) >> 27);
+        unsigned int rotation = (unsigned int) (old_state >> 59);
+        return (xorshifted >> rotation) | (xorshifted << ((32 - rotation) & 31));
+    }
+
+    // Uniform in [0, bound)
+    int next_int(int bound) { return (int) (((unsigned long long) next() * (unsigned int) bound) >> 32); }
+
+    // Uniform in [min, max)
+    float next_float(float min, float max) { return min + (max - min) * (next() >> 8) * (1.0f / 16777216.0f); }
+};
+
+#endif // RNG_H
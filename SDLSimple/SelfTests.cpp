@@ -0,0 +1,285 @@
+#define LOG(argument) std::cout << argument << '\n'
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "AabbBatch.h"
+#include "Entity.h"
+#include "EntityPool.h"
+#include "GameState.h"
+#include "Rng.h"
+#include "SelfTests.h"
+
+// ————— AABB BATCH ————— //
+constexpr int AABB_TEST_QUERIES = 2000;
+constexpr int AABB_TEST_MAX_BOXES = 3 * AABB_BATCH_WIDTH + 3;   // so most pools end on a partial batch
+// Overlap depths may differ from the scalar reference by this much (boxes span a few units)
+constexpr float AABB_TEST_DEPTH_TOLERANCE = 1e-5f;
+
+// Random boxes on a 1/8 grid, so edges often touch exactly (touching is not an overlap); off the grid
+// they are nudged by a fraction of a step, so depths carry rounding
+static void randomise_box(Rng& rng, bool on_grid, glm::vec3& position, float& width, float& height)
+{
+    position = glm::vec3(rng.next_int(33) / 8.0f - 2.0f, rng.next_int(33) / 8.0f - 2.0f, 0.0f);
+    width  = (rng.next_int(16) + 1) / 8.0f;
+    height = (rng.next_int(16) + 1) / 8.0f;
+
+    if (on_grid) { return; }
+    position += glm::vec3(rng.next_float(-0.06f, 0.06f), rng.next_float(-0.06f, 0.06f), 0.0f);
+    width  += rng.next_float(0.0f, 0.06f);
+    height += rng.next_float(0.0f, 0.06f);
+}
+
+bool run_aabb_self_test()
+{
+    const AabbBackend backends[] = { AABB_SCALAR, AABB_SSE2, AABB_AVX };
+
+    Rng rng(3);
+    EntityPool pool;
+    Entity query;
+    query.activate();
+
+    long long lanes_checked = 0, hits = 0, depths_checked = 0;
+
+    for (int test = 0; test < AABB_TEST_QUERIES; test++)
+    {
+        bool on_grid = test % 2 == 0;
+        int box_count = rng.next_int(AABB_TEST_MAX_BOXES) + 1;
+        pool.resize(0);
+        pool.resize(box_count);
+
+        for (int index = 0; index < box_count; index++)
+        {
+            glm::vec3 position;
+            float width, height;
+            randomise_box(rng, on_grid, position, width, height);
+
+            pool[index].set_position(position);
+            pool[index].set_width(width);
+            pool[index].set_height(height);
+            if (rng.next_int(4) == 0) { pool[index].deactivate(); }
+        }
+
+        glm::vec3 query_position;
+        float query_width, query_height;
+        randomise_box(rng, on_grid, query_position, query_width, query_height);
+
+        // Every 16th query sits exactly on the first box's right edge
+        if (test % 16 == 0)
+        {
+            query_position.x = pool.get_x()[0] + pool.get_half_width()[0] + query_width / 2.0f;
+            query_position.y = pool.get_y()[0];
+        }
+
+        query.set_position(query_position);
+        query.set_width(query_width);
+        query.set_height(query_height);
+
+        // Lay batches out the way Entity's next_overlap does: inactive and past-the-end lanes cleared
+        for (int start = 0; start < box_count; start += AABB_BATCH_WIDTH)
+        {
+            AabbBatch batch;
+            for (int lane = 0; lane < AABB_BATCH_WIDTH; lane++)
+            {
+                int index = start + lane;
+                if (index >= box_count || !(pool.get_flags()[index] & ENTITY_ACTIVE))
+                {
+                    aabb_batch_clear_lane(batch, lane);
+                    continue;
+                }
+
+                batch.x[lane]           = pool.get_x()[index];
+                batch.y[lane]           = pool.get_y()[index];
+                batch.half_width[lane]  = pool.get_half_width()[index];
+                batch.half_height[lane] = pool.get_half_height()[index];
+            }
+
+            unsigned int expected = 0;
+            for (int lane = 0; lane < AABB_BATCH_WIDTH && start + lane < box_count; lane++)
+            {
+                if (query.check_collision(&pool, start + lane)) { expected |= 1u << lane; hits++; }
+            }
+
+            for (AabbBackend backend : backends)
+            {
+                if (!aabb_backend_available(backend)) { continue; }
+
+                float overlap_x[AABB_BATCH_WIDTH], overlap_y[AABB_BATCH_WIDTH];
+                unsigned int mask = aabb_overlap_batch_on(backend, query_position.x, query_position.y,
+                                                          query_width / 2.0f, query_height / 2.0f,
+                                                          batch, overlap_x, overlap_y);
+                if (mask != expected)
+                {
+                    LOG("aabb: " << aabb_backend_name(backend) << " mask " << mask << " != check_collision "
+                        << expected << " (query " << test << ", batch at " << start << ")");
+                    return false;
+                }
+
+                // The depths resolve_collisions pushes by, on every hit lane
+                for (int lane = 0; lane < AABB_BATCH_WIDTH; lane++)
+                {
+                    if (!(mask & (1u << lane))) { continue; }
+
+                    float expected_x = query.overlap_x(&pool, start + lane);
+                    float expected_y = query.overlap_y(&pool, start + lane);
+                    if (fabsf(overlap_x[lane] - expected_x) > AABB_TEST_DEPTH_TOLERANCE ||
+                        fabsf(overlap_y[lane] - expected_y) > AABB_TEST_DEPTH_TOLERANCE)
+                    {
+                        LOG("aabb: " << aabb_backend_name(backend) << " depth (" << overlap_x[lane] << ", "
+                            << overlap_y[lane] << ") != (" << expected_x << ", " << expected_y << ") (query "
+                            << test << ", box " << start + lane << ")");
+                        return false;
+                    }
+                    depths_checked++;
+                }
+            }
+
+            lanes_checked += AABB_BATCH_WIDTH;
+        }
+    }
+
+    std::cout << "aabb: ok, " << lanes_checked << " lanes (" << hits << " overlaps, " << depths_checked
+              << " depth pairs) on";
+    for (AabbBackend backend : backends)
+    {
+        if (aabb_backend_available(backend)) { std::cout << ' ' << aabb_backend_name(backend); }
+    }
+    std::cout << '\n';
+    return true;
+}
+
+// ————— SWEPT COLLISIONS ————— //
+constexpr float SWEPT_TEST_DT_SCALES[] = { 2.0f, 8.0f, 30.0f, 60.0f };
+constexpr int SWEPT_TEST_MAX_STEPS = 600;
+// Float rounding allowed on top of CONTACT_SKIN around y = 1
+constexpr float SWEPT_TEST_EPSILON = 1e-6f;
+
+static void add_platform(EntityPool& pool, glm::vec3 position, float width, float height)
+{
+    int index = pool.add();
+    pool[index].set_position(position);
+    pool[index].set_width(width);
+    pool[index].set_height(height);
+}
+
+static void place_lander(Entity& lander, glm::vec3 position, glm::vec3 velocity)
+{
+    lander = Entity();
+    lander.set_collision_mode(SWEPT);
+    lander.set_width(0.5f);
+    lander.set_height(0.5f);
+    lander.set_position(position);
+    lander.set_velocity(velocity);
+}
+
+// Gap between the lander's bottom face and a platform's top face
+static float const gap_above(const Entity& lander, const EntityPool& pool, int index)
+{
+    return (lander.get_position().y - lander.get_height() / 2.0f) - (pool.get_y()[index] + pool.get_half_height()[index]);
+}
+
+// Falls at MAX_VELOCITY onto a platform much thinner than one step's travel
+static bool check_thin_platform(float dt_scale)
+{
+    EntityPool pool;
+    add_platform(pool, glm::vec3(0.0f), 3.0f, 0.05f);
+
+    Entity lander;
+    place_lander(lander, glm::vec3(0.0f, 3.0f, 0.0f), glm::vec3(0.0f, -Entity::MAX_VELOCITY, 0.0f));
+
+    float dt = FIXED_TIMESTEP * dt_scale;
+    for (int step = 0; step < SWEPT_TEST_MAX_STEPS; step++)
+    {
+        CollisionType result = lander.update(dt, &pool);
+
+        if (gap_above(lander, pool, 0) < 0.0f)
+        {
+            LOG("swept: tunnelled through a thin platform at dt x" << dt_scale << " (step " << step << ")");
+            return false;
+        }
+
+        if (result == NOCOLLISION) { continue; }
+
+        float gap = gap_above(lander, pool, 0);
+        if (!lander.get_collided_bottom() || gap > Entity::CONTACT_SKIN + SWEPT_TEST_EPSILON)
+        {
+            LOG("swept: landing at dt x" << dt_scale << " left a gap of " << gap);
+            return false;
+        }
+        return true;
+    }
+
+    LOG("swept: never landed on a thin platform at dt x" << dt_scale);
+    return false;
+}
+
+// Heads diagonally into a platform's top-left corner, where entry times on both axes tie
+static bool check_corner_hit(float dt_scale)
+{
+    EntityPool pool;
+    add_platform(pool, glm::vec3(0.0f), 1.0f, 1.0f);
+
+    float dt = FIXED_TIMESTEP * dt_scale;
+    float speed = Entity::MAX_VELOCITY * 0.7f;
+
+    // Corners meet halfway through the step
+    glm::vec3 displacement = glm::vec3(speed, -speed, 0.0f) * dt;
+    glm::vec3 touching = glm::vec3(-0.75f, 0.75f, 0.0f);
+
+    Entity lander;
+    place_lander(lander, touching - displacement / 2.0f, glm::vec3(speed, -speed, 0.0f));
+
+    CollisionType result = lander.update(dt, &pool);
+
+    // Either face is a fair stop for an exact corner hit, but the lander must end on the outside of one
+    bool above   = gap_above(lander, pool, 0) >= 0.0f;
+    bool left_of = lander.get_position().x + lander.get_width() / 2.0f <= pool.get_x()[0] - pool.get_half_width()[0];
+    if (result == NOCOLLISION || lander.check_collision(&pool, 0) || !(above || left_of))
+    {
+        LOG("swept: missed a corner hit at dt x" << dt_scale << ", ended at (" << lander.get_position().x << ", "
+            << lander.get_position().y << ")");
+        return false;
+    }
+    return true;
+}
+
+// Lands partway through a diagonal step on a floor of two tiles and slides across their seam
+static bool check_slide(float dt_scale)
+{
+    EntityPool pool;
+    add_platform(pool, glm::vec3(0.0f), 2.0f, 1.0f);
+    add_platform(pool, glm::vec3(2.0f, 0.0f, 0.0f), 2.0f, 1.0f);
+
+    float dt = FIXED_TIMESTEP * dt_scale;
+    glm::vec3 velocity = glm::vec3(Entity::MAX_VELOCITY * 0.8f, -Entity::MAX_VELOCITY * 0.4f, 0.0f);
+    glm::vec3 displacement = velocity * dt;
+
+    // Lands after a quarter of the step, then slides the rest of the way
+    glm::vec3 start = glm::vec3(-0.5f, 0.75f - displacement.y / 4.0f, 0.0f);
+
+    Entity lander;
+    place_lander(lander, start, velocity);
+    lander.update(dt, &pool);
+
+    float gap = gap_above(lander, pool, 0);
+    float expected_x = start.x + displacement.x;
+    if (!lander.get_collided_bottom() || gap < 0.0f || gap > Entity::CONTACT_SKIN + SWEPT_TEST_EPSILON ||
+        fabsf(lander.get_position().x - expected_x) > SWEPT_TEST_EPSILON * 10.0f)
+    {
+        LOG("swept: slide at dt x" << dt_scale << " ended " << gap << " off the floor at x "
+            << lander.get_position().x << " (expected " << expected_x << ")");
+        return false;
+    }
+    return true;
+}
+
+bool run_swept_self_test()
+{
+    for (float dt_scale : SWEPT_TEST_DT_SCALES)
+    {
+        if (!check_thin_platform(dt_scale) || !check_corner_hit(dt_scale) || !check_slide(dt_scale)) { return false; }
+    }
+
+    LOG("swept: ok, thin platform, corner hit and slide at dt x2 to x60");
+    return true;
+}
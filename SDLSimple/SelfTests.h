@@ -0,0 +1,14 @@
+#ifndef SELF_TESTS_H
+#define SELF_TESTS_H
+
+// Each check logs what it covered and returns false on the first mismatch, so
+// lunar_headless can exit non-zero from a CI job.
+
+// Every compiled aabb_overlap_batch backend against Entity::check_collision
+bool run_aabb_self_test();
+
+// SWEPT mode at steps far above FIXED_TIMESTEP: no tunnelling through a thin
+// platform, corner hits caught, slides kept within CONTACT_SKIN of the face
+bool run_swept_self_test();
+
+#endif // SELF_TESTS_H
@@ -1,26 +1,211 @@
 #define GL_SILENCE_DEPRECATION
 
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <initializer_list>
+#include <vector>
 #include "ShaderProgram.h"
+#include "GLStateCache.h"
+
+// glGetProgramBinary is core since 4.1 and ARB_get_program_binary before that;
+// Apple's GL has neither, so there the cache compiles out
+#ifndef __APPLE__
+#define SHADER_BINARY_CACHE 1
+#else
+#define SHADER_BINARY_CACHE 0
+#endif
+
+// Bump when the file layout changes so old files simply miss
+constexpr uint32_t BINARY_CACHE_VERSION = 1;
+constexpr char BINARY_CACHE_MAGIC[4] = { 'L', 'S', 'P', 'B' };
+// Real program binaries are tens of KB; anything past this is a corrupt header
+constexpr uint32_t MAX_BINARY_CACHE_LENGTH = 64 * 1024 * 1024;
+
+struct BinaryCacheHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t binary_format;
+    uint32_t length;
+};
+
+std::string ShaderProgram::s_binary_cache_directory;
+
+void ShaderProgram::set_binary_cache_directory(const std::string &directory)
+{
+    s_binary_cache_directory = directory;
+}
+
+static std::string read_shader_file(const char *filepath)
+{
+    std::ifstream infile(filepath, std::ios::binary);
+    
+    if(infile.fail()) {
+        std::cout << "Error opening shader file:" << filepath << std::endl;
+        return std::string();
+    }
+    
+    // One read of the whole file rather than a stringstream copy
+    infile.seekg(0, std::ios::end);
+    std::string contents((size_t) infile.tellg(), '\0');
+    infile.seekg(0, std::ios::beg);
+    infile.read(&contents[0], contents.size());
+    return contents;
+}
+
+// FNV-1a, folding in each part and a separator so ("ab", "c") and ("a", "bc") differ
+static uint64_t hash_parts(std::initializer_list<const char*> parts)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const char *part : parts)
+    {
+        for (const char *c = part != nullptr ? part : ""; *c != '\0'; c++)
+        {
+            hash = (hash ^ (unsigned char) *c) * 1099511628211ull;
+        }
+        hash = (hash ^ 0xFF) * 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string const ShaderProgram::binary_cache_path(const std::string &vertex_source, const std::string &fragment_source) const
+{
+#if SHADER_BINARY_CACHE
+    if (s_binary_cache_directory.empty()) { return std::string(); }
+
+    GLint format_count = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    if (format_count == 0) { return std::string(); }
+
+    // A driver update changes these strings, so its binaries never meet the old driver's
+    uint64_t key = hash_parts({ vertex_source.c_str(), fragment_source.c_str(),
+                                (const char*) glGetString(GL_VENDOR), (const char*) glGetString(GL_RENDERER),
+                                (const char*) glGetString(GL_VERSION) });
+
+    char filename[32];
+    snprintf(filename, sizeof(filename), "%016llx.bin", (unsigned long long) key);
+    return (std::filesystem::path(s_binary_cache_directory) / filename).string();
+#else
+    return std::string();
+#endif
+}
+
+bool ShaderProgram::load_cached_binary(const std::string &cache_path)
+{
+#if SHADER_BINARY_CACHE
+    std::ifstream file(cache_path, std::ios::binary);
+    if (!file) { return false; }
+
+    BinaryCacheHeader header;
+    if (!file.read((char*) &header, sizeof(header)) || memcmp(header.magic, BINARY_CACHE_MAGIC, 4) != 0 ||
+        header.version != BINARY_CACHE_VERSION)
+    {
+        return false;
+    }
+
+    // The length comes from disk: it must be exactly what follows the header before anything is allocated
+    std::error_code error;
+    uintmax_t file_size = std::filesystem::file_size(cache_path, error);
+    if (error || header.length == 0 || header.length > MAX_BINARY_CACHE_LENGTH ||
+        file_size != sizeof(header) + (uintmax_t) header.length)
+    {
+        return false;
+    }
+
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), binary.size())) { return false; }
+
+    glProgramBinary(m_program_id, header.binary_format, binary.data(), (GLsizei) binary.size());
+
+    GLint link_success;
+    glGetProgramiv(m_program_id, GL_LINK_STATUS, &link_success);
+    if (link_success == GL_FALSE)
+    {
+        // Drivers may reject their own older binaries; start over from source
+        std::cout << "Cached shader binary " << cache_path << " rejected; compiling from source" << std::endl;
+        GLStateCache::get().forget_program(m_program_id);
+        glDeleteProgram(m_program_id);
+        m_program_id = glCreateProgram();
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ShaderProgram::save_binary(const std::string &cache_path) const
+{
+#if SHADER_BINARY_CACHE
+    GLint length = 0;
+    glGetProgramiv(m_program_id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) { return; }
+
+    BinaryCacheHeader header;
+    memcpy(header.magic, BINARY_CACHE_MAGIC, 4);
+    header.version = BINARY_CACHE_VERSION;
+
+    std::vector<char> binary(length);
+    GLenum binary_format;
+    glGetProgramBinary(m_program_id, length, &length, &binary_format, binary.data());
+    header.binary_format = binary_format;
+    header.length = (uint32_t) length;
+
+    std::error_code error;
+    std::filesystem::create_directories(s_binary_cache_directory, error);
+
+    // Written aside and renamed into place, so another instance never reads half a file
+    std::string temporary_path = cache_path + ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::binary);
+        file.write((const char*) &header, sizeof(header));
+        file.write(binary.data(), length);
+        if (!file) { std::cout << "Unable to write shader cache " << temporary_path << std::endl; return; }
+    }
+    std::filesystem::rename(temporary_path, cache_path, error);
+#endif
+}
 
 void ShaderProgram::load(const char *vertex_shader_file, const char *fragment_shader_file) {
     
-    // create the vertex shader
-    m_vertex_shader = load_shader_from_file(vertex_shader_file, GL_VERTEX_SHADER);
-    // create the fragment shader
-    m_fragment_shader = load_shader_from_file(fragment_shader_file, GL_FRAGMENT_SHADER);
+    std::string vertex_source = read_shader_file(vertex_shader_file);
+    std::string fragment_source = read_shader_file(fragment_shader_file);
     
-    // Create the final shader program from our vertex and fragment shaders
     m_program_id = glCreateProgram();
-    glAttachShader(m_program_id, m_vertex_shader);
-    glAttachShader(m_program_id, m_fragment_shader);
-    glLinkProgram(m_program_id);
+    m_vertex_shader = 0;
+    m_fragment_shader = 0;
     
-    GLint link_success;
-    glGetProgramiv(m_program_id, GL_LINK_STATUS, &link_success);
+    std::string cache_path = binary_cache_path(vertex_source, fragment_source);
+    m_from_binary_cache = !cache_path.empty() && load_cached_binary(cache_path);
     
-    if(link_success == GL_FALSE)
+    if (!m_from_binary_cache)
     {
-        printf("Error linking shader program!\n");
+        // create the vertex shader
+        m_vertex_shader = load_shader_from_string(vertex_source, GL_VERTEX_SHADER);
+        // create the fragment shader
+        m_fragment_shader = load_shader_from_string(fragment_source, GL_FRAGMENT_SHADER);
+        
+        // Create the final shader program from our vertex and fragment shaders
+        glAttachShader(m_program_id, m_vertex_shader);
+        glAttachShader(m_program_id, m_fragment_shader);
+#if SHADER_BINARY_CACHE
+        if (!cache_path.empty()) { glProgramParameteri(m_program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE); }
+#endif
+        glLinkProgram(m_program_id);
+        
+        GLint link_success;
+        glGetProgramiv(m_program_id, GL_LINK_STATUS, &link_success);
+        
+        if(link_success == GL_FALSE)
+        {
+            printf("Error linking shader program!\n");
+        }
+        else if (!cache_path.empty())
+        {
+            save_binary(cache_path);
+        }
     }
     
     m_model_matrix_uniform      = glGetUniformLocation(m_program_id, "modelMatrix");
@@ -30,6 +215,8 @@ void ShaderProgram::load(const char *vertex_shader_file, const char *fragment_sh
     
     m_position_attribute  = glGetAttribLocation(m_program_id, "position");
     m_tex_coord_attribute = glGetAttribLocation(m_program_id, "texCoord");
+    m_instance_transform_attribute = glGetAttribLocation(m_program_id, "instanceTransform");
+    m_instance_uv_attribute        = glGetAttribLocation(m_program_id, "instanceUv");
     
     set_colour(1.0f, 1.0f, 1.0f, 1.0f);
     
@@ -37,28 +224,12 @@ void ShaderProgram::load(const char *vertex_shader_file, const char *fragment_sh
 
 void ShaderProgram::cleanup()
 {
+    GLStateCache::get().forget_program(m_program_id);
     glDeleteProgram(m_program_id);
     glDeleteShader(m_vertex_shader);
     glDeleteShader(m_fragment_shader);
 }
 
-GLuint ShaderProgram::load_shader_from_file(const std::string &shaderFile, GLenum type)
-{
-    //Open a file stream with the file name
-    std::ifstream infile(shaderFile);
-    
-    if(infile.fail()) {
-        std::cout << "Error opening shader file:" << shaderFile << std::endl;
-    }
-    
-    //Create a string buffer and stream the file to it
-    std::stringstream buffer;
-    buffer << infile.rdbuf();
-    
-    // Load the shader from the contents of the file
-    return load_shader_from_string(buffer.str(), type);
-}
-
 GLuint ShaderProgram::load_shader_from_string(const std::string &shaderContents, GLenum type)
 {
     // Create a shader of specified type
@@ -90,24 +261,24 @@ GLuint ShaderProgram::load_shader_from_string(const std::string &shaderContents,
 
 void ShaderProgram::set_colour(float red, float green, float blue, float alpha)
 {
-    glUseProgram(m_program_id);
-    glUniform4f(m_colour_uniform, red, green, blue, alpha);
+    GLStateCache::get().use_program(m_program_id);
+    GLStateCache::get().set_uniform_vec4(m_colour_uniform, red, green, blue, alpha);
 }
 
 void ShaderProgram::set_view_matrix(const glm::mat4 &matrix)
 {
-    glUseProgram(m_program_id);
-    glUniformMatrix4fv(m_view_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
+    GLStateCache::get().use_program(m_program_id);
+    GLStateCache::get().set_uniform_matrix(m_view_matrix_uniform, matrix);
 }
 
 void ShaderProgram::set_model_matrix(const glm::mat4 &matrix)
 {
-    glUseProgram(m_program_id);
-    glUniformMatrix4fv(m_model_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
+    GLStateCache::get().use_program(m_program_id);
+    GLStateCache::get().set_uniform_matrix(m_model_matrix_uniform, matrix);
 }
 
 void ShaderProgram::set_projection_matrix(const glm::mat4 &matrix)
 {
-    glUseProgram(m_program_id);
-    glUniformMatrix4fv(m_projection_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
+    GLStateCache::get().use_program(m_program_id);
+    GLStateCache::get().set_uniform_matrix(m_projection_matrix_uniform, matrix);
 }
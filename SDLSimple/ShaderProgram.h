@@ -17,7 +17,12 @@ private:
     void cleanup();
     
     GLuint load_shader_from_string(const std::string &shader_contents, GLenum shader_type);
-    GLuint load_shader_from_file(const std::string &shader_file, GLenum shader_type);
+
+    // Program binary cache: see set_binary_cache_directory
+    static std::string s_binary_cache_directory;
+    std::string const binary_cache_path(const std::string &vertex_source, const std::string &fragment_source) const;
+    bool load_cached_binary(const std::string &cache_path);
+    void save_binary(const std::string &cache_path) const;
 
     GLuint m_program_id;
 
@@ -28,11 +33,22 @@ private:
 
     GLuint m_position_attribute;
     GLuint m_tex_coord_attribute;
+    GLuint m_instance_transform_attribute;   // only in the instanced shader; ~0 elsewhere
+    GLuint m_instance_uv_attribute;
 
     GLuint m_vertex_shader;
     GLuint m_fragment_shader;
+
+    bool m_from_binary_cache = false;
     
 public:
+    // Linked programs are stored in `directory` as driver binaries
+    // (glGetProgramBinary), one file per hash of the two sources plus the GL
+    // vendor, renderer and version strings, and later loads link from them with
+    // glProgramBinary. A miss, or a binary the driver rejects after an update,
+    // compiles from source and rewrites the file. Empty (the default) turns it
+    // off, as does a driver with no binary formats; macOS has none.
+    static void set_binary_cache_directory(const std::string &directory);
 
     void load(const char *vertex_shader_file, const char *fragment_shader_file);
 
@@ -44,6 +60,9 @@ public:
     GLuint const get_program_id()               const { return m_program_id;          };
     GLuint const get_position_attribute()       const { return m_position_attribute;  };
     GLuint const get_tex_coordinate_attribute() const { return m_tex_coord_attribute; };
+    GLuint const get_instance_transform_attribute() const { return m_instance_transform_attribute; };
+    GLuint const get_instance_uv_attribute()        const { return m_instance_uv_attribute;        };
+    bool const is_from_binary_cache()               const { return m_from_binary_cache;            };
     
     void set_program_id(GLuint program_id)                         { m_program_id = program_id;                   };
 };
@@ -0,0 +1,48 @@
+#ifndef SNAPSHOT_RING_H
+#define SNAPSHOT_RING_H
+
+#include <cstring>
+#include <vector>
+#include "GameState.h"
+
+constexpr int DEFAULT_REWIND_STEPS = 600;   // 10 s of fixed steps
+
+/**
+ * The last N SimState snapshots, newest on top. Storage is allocated once;
+ * push overwrites the oldest snapshot when full and pop hands back the newest,
+ * so holding rewind walks the simulation backwards one step at a time.
+ */
+class SnapshotRing
+{
+private:
+    std::vector<SimState> m_snapshots;
+    int m_head = 0;    // next slot to write
+    int m_count = 0;
+
+public:
+    SnapshotRing(int capacity = DEFAULT_REWIND_STEPS) : m_snapshots(capacity > 0 ? capacity : 1) {}
+
+    void push(const SimState& snapshot)
+    {
+        memcpy((void*) &m_snapshots[m_head], &snapshot, sizeof(SimState));
+        m_head = (m_head + 1) % (int) m_snapshots.size();
+        if (m_count < (int) m_snapshots.size()) { m_count++; }
+    }
+
+    bool pop(SimState& snapshot)
+    {
+        if (m_count == 0) { return false; }
+
+        m_head = (m_head + (int) m_snapshots.size() - 1) % (int) m_snapshots.size();
+        m_count--;
+        memcpy((void*) &snapshot, &m_snapshots[m_head], sizeof(SimState));
+        return true;
+    }
+
+    void clear() { m_head = 0; m_count = 0; }
+
+    int const size()     const { return m_count; }
+    int const capacity() const { return (int) m_snapshots.size(); }
+};
+
+#endif // SNAPSHOT_RING_H
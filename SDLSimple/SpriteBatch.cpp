@@ -0,0 +1,133 @@
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cstring>
+#include "SpriteBatch.h"
+#include "ShaderProgram.h"
+#include "GLStateCache.h"
+#include "Profiler.h"
+
+// Two triangles over the unit quad, same winding Entity::render used. The UVs
+// are 0..1 across the sprite and get remapped onto its atlas sub-rectangle.
+static const float QUAD_CORNERS[]  = { -0.5, -0.5, 0.5, -0.5, 0.5, 0.5, -0.5, -0.5, 0.5, 0.5, -0.5, 0.5 };
+static const float QUAD_TEX_COORDS[] = { 0.0,  1.0, 1.0,  1.0, 1.0, 0.0,  0.0,  1.0, 1.0, 0.0,  0.0, 0.0 };
+
+constexpr int VERTICES_PER_QUAD = 6;
+constexpr int FLOATS_PER_VERTEX = 4;
+
+SpriteBatch::~SpriteBatch()
+{
+    release();
+}
+
+void SpriteBatch::release()
+{
+    if (m_vertex_buffer == 0) { return; }
+
+    // Deleting a bound buffer unbinds it, so the cached binding would go stale
+    glDeleteBuffers(1, &m_vertex_buffer);
+    GLStateCache::get().invalidate();
+
+    m_vertex_buffer = 0;
+    m_buffer_capacity = 0;
+}
+
+void SpriteBatch::begin(ShaderProgram* program)
+{
+    m_program = program;
+    m_draw_calls = 0;
+    m_sprite_count = 0;
+    m_quads.clear();
+
+    if (m_vertex_buffer == 0) { glGenBuffers(1, &m_vertex_buffer); }
+}
+
+void SpriteBatch::draw(const AtlasSprite& sprite, const glm::mat4& model_matrix)
+{
+    m_quads.emplace_back();
+    Quad& quad = m_quads.back();
+    quad.texture_id = sprite.page_texture_id;
+
+    for (int i = 0; i < VERTICES_PER_QUAD; i++)
+    {
+        glm::vec4 corner = model_matrix * glm::vec4(QUAD_CORNERS[i * 2], QUAD_CORNERS[i * 2 + 1], 0.0f, 1.0f);
+
+        quad.vertices[i * FLOATS_PER_VERTEX]     = corner.x;
+        quad.vertices[i * FLOATS_PER_VERTEX + 1] = corner.y;
+        quad.vertices[i * FLOATS_PER_VERTEX + 2] = glm::mix(sprite.uv_rect.x, sprite.uv_rect.z, QUAD_TEX_COORDS[i * 2]);
+        quad.vertices[i * FLOATS_PER_VERTEX + 3] = glm::mix(sprite.uv_rect.y, sprite.uv_rect.w, QUAD_TEX_COORDS[i * 2 + 1]);
+    }
+}
+
+void SpriteBatch::draw(const AtlasSprite& sprite, float x, float y, float width, float height)
+{
+    m_quads.emplace_back();
+    Quad& quad = m_quads.back();
+    quad.texture_id = sprite.page_texture_id;
+
+    for (int i = 0; i < VERTICES_PER_QUAD; i++)
+    {
+        quad.vertices[i * FLOATS_PER_VERTEX]     = x + QUAD_CORNERS[i * 2] * width;
+        quad.vertices[i * FLOATS_PER_VERTEX + 1] = y + QUAD_CORNERS[i * 2 + 1] * height;
+        quad.vertices[i * FLOATS_PER_VERTEX + 2] = glm::mix(sprite.uv_rect.x, sprite.uv_rect.z, QUAD_TEX_COORDS[i * 2]);
+        quad.vertices[i * FLOATS_PER_VERTEX + 3] = glm::mix(sprite.uv_rect.y, sprite.uv_rect.w, QUAD_TEX_COORDS[i * 2 + 1]);
+    }
+}
+
+void SpriteBatch::flush()
+{
+    if (m_quads.empty()) { return; }
+
+    PROFILE_ZONE("SpriteBatch::flush");
+
+    // Group by texture; stable so sprites sharing a texture keep submission order
+    m_order.resize(m_quads.size());
+    for (int i = 0; i < (int) m_quads.size(); i++) { m_order[i] = i; }
+    std::stable_sort(m_order.begin(), m_order.end(), [this](int a, int b)
+                     { return m_quads[a].texture_id < m_quads[b].texture_id; });
+
+    m_stream.resize(m_quads.size() * VERTICES_PER_QUAD * FLOATS_PER_VERTEX);
+    for (int i = 0; i < (int) m_order.size(); i++)
+    {
+        memcpy(&m_stream[i * VERTICES_PER_QUAD * FLOATS_PER_VERTEX], m_quads[m_order[i]].vertices,
+               sizeof(Quad::vertices));
+    }
+
+    GLsizeiptr bytes = (GLsizeiptr) (m_stream.size() * sizeof(float));
+    GLStateCache& state = GLStateCache::get();
+
+    state.bind_array_buffer(m_vertex_buffer);
+    if (bytes > m_buffer_capacity) { m_buffer_capacity = std::max(bytes, m_buffer_capacity * 2); }
+
+    // Orphan last flush's storage so the driver never stalls waiting on it
+    glBufferData(GL_ARRAY_BUFFER, m_buffer_capacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, m_stream.data());
+
+    GLsizei stride = FLOATS_PER_VERTEX * sizeof(float);
+    glVertexAttribPointer(m_program->get_position_attribute(), 2, GL_FLOAT, false, stride, (void*) 0);
+    state.enable_vertex_attribute(m_program->get_position_attribute());
+    glVertexAttribPointer(m_program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, stride,
+                          (void*) (2 * sizeof(float)));
+    state.enable_vertex_attribute(m_program->get_tex_coordinate_attribute());
+
+    m_program->set_model_matrix(glm::mat4(1.0f));
+
+    int run_start = 0;
+    for (int i = 1; i <= (int) m_order.size(); i++)
+    {
+        GLuint texture_id = m_quads[m_order[run_start]].texture_id;
+        if (i < (int) m_order.size() && m_quads[m_order[i]].texture_id == texture_id) { continue; }
+
+        state.bind_texture(0, texture_id);
+        glDrawArrays(GL_TRIANGLES, run_start * VERTICES_PER_QUAD, (i - run_start) * VERTICES_PER_QUAD);
+        m_draw_calls++;
+
+        run_start = i;
+    }
+
+    // Attributes and the buffer stay bound: everything on screen goes through the
+    // batch, so the next flush finds them already set and the cache skips the calls
+
+    m_sprite_count += (int) m_quads.size();
+    m_quads.clear();
+}
@@ -0,0 +1,78 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/glm.hpp"
+#include "TextureAtlas.h"
+
+class ShaderProgram;
+
+/**
+ * Collects textured quads for a frame and draws them with one glDrawArrays per
+ * atlas page instead of one per sprite. With every sprite on one page that is
+ * one texture bind and one draw for the whole scene.
+ *
+ * Corners are transformed on the CPU, so the shader's model matrix stays at
+ * identity for the whole batch. Vertices are interleaved (x, y, u, v) and
+ * streamed into a single VBO that is orphaned on every flush.
+ *
+ * Quads are grouped by page. Within a page they keep submission order; across
+ * pages order only holds between flushes, so call flush() before anything on
+ * another page that has to land on top.
+ */
+class SpriteBatch
+{
+private:
+    struct Quad
+    {
+        GLuint texture_id;
+        float vertices[24];     // 6 vertices * (x, y, u, v)
+    };
+
+    ShaderProgram* m_program = nullptr;
+    GLuint m_vertex_buffer = 0;
+    GLsizeiptr m_buffer_capacity = 0;   // bytes
+
+    std::vector<Quad> m_quads;
+    std::vector<int> m_order;           // m_quads indices, sorted by texture on flush
+    std::vector<float> m_stream;        // staging copy uploaded to the VBO
+
+    int m_draw_calls = 0;
+    int m_sprite_count = 0;
+
+public:
+    SpriteBatch() = default;
+    ~SpriteBatch();
+
+    SpriteBatch(const SpriteBatch&) = delete;
+    SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+    // Deletes the VBO. Call before the GL context goes away; a global batch's
+    // destructor runs after SDL_Quit, when there is no context left to call into.
+    void release();
+
+    // Starts a frame: resets the counters. Needs a current GL context.
+    void begin(ShaderProgram* program);
+
+    // Queues the unit quad centred on the origin, transformed by `model_matrix`
+    void draw(const AtlasSprite& sprite, const glm::mat4& model_matrix);
+
+    // Queues an axis-aligned quad; cheaper than building a matrix per sprite
+    void draw(const AtlasSprite& sprite, float x, float y, float width, float height);
+
+    // Uploads and draws everything queued so far, one draw call per atlas page
+    void flush();
+
+    void end() { flush(); }
+
+    int const get_draw_call_count()  const { return m_draw_calls;   }
+    int const get_sprite_count()     const { return m_sprite_count; }
+};
+
+#endif // SPRITE_BATCH_H
@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <cfloat>
+#include "StaticBvh.h"
+
+namespace
+{
+    struct Bounds
+    {
+        float min_x = FLT_MAX, min_y = FLT_MAX, max_x = -FLT_MAX, max_y = -FLT_MAX;
+
+        void grow(float x0, float y0, float x1, float y1)
+        {
+            min_x = std::min(min_x, x0); min_y = std::min(min_y, y0);
+            max_x = std::max(max_x, x1); max_y = std::max(max_y, y1);
+        }
+        void grow(const Bounds& other) { grow(other.min_x, other.min_y, other.max_x, other.max_y); }
+
+        // 2D stand-in for surface area: a random line hits a box in proportion to its perimeter
+        float const half_perimeter() const { return min_x > max_x ? 0.0f : (max_x - min_x) + (max_y - min_y); }
+    };
+
+    struct BuildTask
+    {
+        int node, begin, end, depth;
+    };
+
+    // Where the ray enters the box, clipped to [0, max_distance]; false when it misses
+    bool const ray_box(glm::vec2 origin, glm::vec2 direction, glm::vec2 inverse_direction,
+                       float min_x, float min_y, float max_x, float max_y, float max_distance, float* enter)
+    {
+        float t_min = 0.0f, t_max = max_distance;
+        const float lower[2] = { min_x, min_y };
+        const float upper[2] = { max_x, max_y };
+
+        for (int axis = 0; axis < 2; axis++)
+        {
+            if (direction[axis] == 0.0f)
+            {
+                if (origin[axis] < lower[axis] || origin[axis] > upper[axis]) { return false; }
+                continue;
+            }
+
+            float t0 = (lower[axis] - origin[axis]) * inverse_direction[axis];
+            float t1 = (upper[axis] - origin[axis]) * inverse_direction[axis];
+            if (t0 > t1) { std::swap(t0, t1); }
+
+            t_min = std::max(t_min, t0);
+            t_max = std::min(t_max, t1);
+            if (t_min > t_max) { return false; }
+        }
+
+        *enter = t_min;
+        return true;
+    }
+}
+
+void StaticBvh::clear()
+{
+    m_nodes.clear();
+    m_leaf_ids.clear();
+    m_boxes.clear();
+}
+
+void StaticBvh::build(const float* x, const float* y, const float* half_width, const float* half_height, int count)
+{
+    clear();
+    if (count == 0) { return; }
+
+    m_boxes.resize(count);
+    m_leaf_ids.resize(count);
+    std::vector<glm::vec2> centres(count);
+
+    for (int i = 0; i < count; i++)
+    {
+        m_boxes[i] = glm::vec4(x[i] - half_width[i], y[i] - half_height[i], x[i] + half_width[i], y[i] + half_height[i]);
+        centres[i] = glm::vec2(x[i], y[i]);
+        m_leaf_ids[i] = i;
+    }
+
+    m_nodes.reserve(2 * (count / MAX_LEAF_SIZE + 1));
+    m_nodes.push_back(Node());
+
+    std::vector<BuildTask> tasks;
+    tasks.push_back(BuildTask { 0, 0, count, 0 });
+
+    while (!tasks.empty())
+    {
+        BuildTask task = tasks.back();
+        tasks.pop_back();
+
+        Bounds bounds, centre_bounds;
+        for (int slot = task.begin; slot < task.end; slot++)
+        {
+            const glm::vec4& box = m_boxes[m_leaf_ids[slot]];
+            const glm::vec2& centre = centres[m_leaf_ids[slot]];
+            bounds.grow(box.x, box.y, box.z, box.w);
+            centre_bounds.grow(centre.x, centre.y, centre.x, centre.y);
+        }
+
+        Node& node = m_nodes[task.node];
+        node.min_x = bounds.min_x; node.min_y = bounds.min_y;
+        node.max_x = bounds.max_x; node.max_y = bounds.max_y;
+        node.first = task.begin;
+        node.count = task.end - task.begin;
+
+        if (node.count <= MAX_LEAF_SIZE || task.depth >= MAX_DEPTH) { continue; }
+
+        // Bin centres along the wider axis and split where the heuristic cost is lowest
+        int axis = (centre_bounds.max_x - centre_bounds.min_x) >= (centre_bounds.max_y - centre_bounds.min_y) ? 0 : 1;
+        float axis_min    = axis == 0 ? centre_bounds.min_x : centre_bounds.min_y;
+        float axis_extent = axis == 0 ? centre_bounds.max_x - axis_min : centre_bounds.max_y - axis_min;
+
+        int middle;
+        if (axis_extent <= 0.0f)
+        {
+            // Every centre coincides: no plane separates them, so halve the run
+            middle = (task.begin + task.end) / 2;
+        }
+        else
+        {
+            float bin_scale = BIN_COUNT * (1.0f - 1e-5f) / axis_extent;
+            auto bin_of = [&](int id)
+            {
+                return std::min((int) ((centres[id][axis] - axis_min) * bin_scale), BIN_COUNT - 1);
+            };
+
+            Bounds bin_bounds[BIN_COUNT];
+            int bin_counts[BIN_COUNT] = {};
+            for (int slot = task.begin; slot < task.end; slot++)
+            {
+                int id = m_leaf_ids[slot];
+                int bin = bin_of(id);
+                bin_counts[bin]++;
+                bin_bounds[bin].grow(m_boxes[id].x, m_boxes[id].y, m_boxes[id].z, m_boxes[id].w);
+            }
+
+            // Sweep from the right for every split's right-hand cost, then from the left to pick
+            float right_cost[BIN_COUNT];
+            Bounds right_bounds;
+            int right_count = 0;
+            for (int bin = BIN_COUNT - 1; bin > 0; bin--)
+            {
+                right_bounds.grow(bin_bounds[bin]);
+                right_count += bin_counts[bin];
+                right_cost[bin] = right_count * right_bounds.half_perimeter();
+            }
+
+            Bounds left_bounds;
+            int left_count = 0, best_split = -1;
+            float best_cost = FLT_MAX;
+            for (int bin = 0; bin < BIN_COUNT - 1; bin++)
+            {
+                left_bounds.grow(bin_bounds[bin]);
+                left_count += bin_counts[bin];
+                if (left_count == 0 || left_count == node.count) { continue; }
+
+                float cost = left_count * left_bounds.half_perimeter() + right_cost[bin + 1];
+                if (cost < best_cost) { best_cost = cost; best_split = bin; }
+            }
+
+            int* split = std::partition(m_leaf_ids.data() + task.begin, m_leaf_ids.data() + task.end,
+                                        [&](int id) { return bin_of(id) <= best_split; });
+            middle = (int) (split - m_leaf_ids.data());
+        }
+
+        int left = (int) m_nodes.size();
+        node.first = left;
+        node.count = 0;
+
+        // `node` may dangle past here
+        m_nodes.push_back(Node());
+        m_nodes.push_back(Node());
+        tasks.push_back(BuildTask { left + 1, middle, task.end, task.depth + 1 });
+        tasks.push_back(BuildTask { left, task.begin, middle, task.depth + 1 });
+    }
+}
+
+void StaticBvh::query(glm::vec3 position, float width, float height, std::vector<int>& out) const
+{
+    if (m_nodes.empty()) { return; }
+
+    size_t first = out.size();
+    float min_x = position.x - width  / 2.0f, max_x = position.x + width  / 2.0f;
+    float min_y = position.y - height / 2.0f, max_y = position.y + height / 2.0f;
+
+    int stack[MAX_DEPTH + 2];
+    int stack_size = 0;
+    stack[stack_size++] = 0;
+
+    while (stack_size > 0)
+    {
+        const Node& node = m_nodes[stack[--stack_size]];
+        if (node.min_x > max_x || node.max_x < min_x || node.min_y > max_y || node.max_y < min_y) { continue; }
+
+        if (node.count == 0)
+        {
+            stack[stack_size++] = node.first + 1;
+            stack[stack_size++] = node.first;
+            continue;
+        }
+
+        for (int slot = node.first; slot < node.first + node.count; slot++)
+        {
+            int id = m_leaf_ids[slot];
+            const glm::vec4& box = m_boxes[id];
+            if (box.x > max_x || box.z < min_x || box.y > max_y || box.w < min_y) { continue; }
+            out.push_back(id);
+        }
+    }
+
+    // Each box lives in exactly one leaf, so only the order needs fixing
+    std::sort(out.begin() + first, out.end());
+}
+
+bool StaticBvh::raycast(glm::vec3 origin, glm::vec3 direction, float max_distance, RayHit* hit) const
+{
+    if (m_nodes.empty()) { return false; }
+
+    glm::vec2 ray_origin(origin.x, origin.y);
+    glm::vec2 ray_direction = glm::normalize(glm::vec2(direction.x, direction.y));
+    glm::vec2 inverse_direction(1.0f / ray_direction.x, 1.0f / ray_direction.y);
+
+    hit->id = -1;
+    hit->distance = max_distance;
+
+    float enter;
+    if (!ray_box(ray_origin, ray_direction, inverse_direction, m_nodes[0].min_x, m_nodes[0].min_y,
+                 m_nodes[0].max_x, m_nodes[0].max_y, max_distance, &enter)) { return false; }
+
+    int stack[MAX_DEPTH + 2];
+    int stack_size = 0;
+    stack[stack_size++] = 0;
+
+    while (stack_size > 0)
+    {
+        const Node& node = m_nodes[stack[--stack_size]];
+
+        if (node.count > 0)
+        {
+            for (int slot = node.first; slot < node.first + node.count; slot++)
+            {
+                int id = m_leaf_ids[slot];
+                const glm::vec4& box = m_boxes[id];
+                if (!ray_box(ray_origin, ray_direction, inverse_direction, box.x, box.y, box.z, box.w,
+                             hit->distance, &enter)) { continue; }
+
+                // Ties go to the lower id, so the answer does not depend on the tree's shape
+                if (enter < hit->distance || hit->id == -1 || (enter == hit->distance && id < hit->id))
+                {
+                    hit->id = id;
+                    hit->distance = enter;
+                }
+            }
+            continue;
+        }
+
+        // Visit the nearer child first so the farther one is usually culled by the hit so far
+        const Node& left  = m_nodes[node.first];
+        const Node& right = m_nodes[node.first + 1];
+        float left_enter, right_enter;
+        bool left_hit  = ray_box(ray_origin, ray_direction, inverse_direction, left.min_x, left.min_y,
+                                 left.max_x, left.max_y, hit->distance, &left_enter);
+        bool right_hit = ray_box(ray_origin, ray_direction, inverse_direction, right.min_x, right.min_y,
+                                 right.max_x, right.max_y, hit->distance, &right_enter);
+
+        if (left_hit && right_hit)
+        {
+            bool left_first = left_enter <= right_enter;
+            stack[stack_size++] = left_first ? node.first + 1 : node.first;
+            stack[stack_size++] = left_first ? node.first : node.first + 1;
+        }
+        else if (left_hit)  { stack[stack_size++] = node.first; }
+        else if (right_hit) { stack[stack_size++] = node.first + 1; }
+    }
+
+    return hit->id != -1;
+}
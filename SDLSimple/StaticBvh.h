@@ -0,0 +1,57 @@
+#ifndef STATIC_BVH_H
+#define STATIC_BVH_H
+
+#include <vector>
+#include "glm/glm.hpp"
+#include "Broadphase.h"
+
+struct RayHit
+{
+    int id = -1;
+    float distance = 0.0f;   // along the normalised ray direction
+};
+
+/**
+ * Bounding volume hierarchy over boxes that never move, such as the level's
+ * platforms. It is built once with a binned surface-area heuristic and
+ * flattened into one array of nodes: both children of a node sit next to each
+ * other and a leaf's boxes are a contiguous run of m_leaf_ids, so queries
+ * stream through memory instead of chasing pointers.
+ *
+ * Boxes are copied in at build time; rebuild if the geometry changes.
+ */
+class StaticBvh : public Broadphase
+{
+private:
+    struct Node
+    {
+        float min_x, min_y, max_x, max_y;
+        int first;   // leaf: first slot in m_leaf_ids; interior: index of the left child (right is first + 1)
+        int count;   // leaf: box count; interior: 0
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<int> m_leaf_ids;
+    std::vector<glm::vec4> m_boxes;   // per id: min x, min y, max x, max y
+
+public:
+    static constexpr int BIN_COUNT = 16;
+    static constexpr int MAX_LEAF_SIZE = 4;
+    static constexpr int MAX_DEPTH = 64;
+
+    // ————— METHODS ————— //
+    // Takes the box layout EntityPool stores: centres and half extents, one entry per id
+    void build(const float* x, const float* y, const float* half_width, const float* half_height, int count);
+    void clear();
+
+    void query(glm::vec3 position, float width, float height, std::vector<int>& out) const override;
+
+    // Nearest box the ray enters within max_distance; a ray starting inside a box hits it at 0
+    bool raycast(glm::vec3 origin, glm::vec3 direction, float max_distance, RayHit* hit) const;
+
+    // ————— GETTERS ————— //
+    int const get_node_count() const { return (int) m_nodes.size(); }
+    int const get_box_count()  const { return (int) m_boxes.size(); }
+};
+
+#endif // STATIC_BVH_H
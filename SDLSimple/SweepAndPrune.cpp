@@ -0,0 +1,112 @@
+#include <algorithm>
+#include "SweepAndPrune.h"
+#include "Profiler.h"
+
+static bool const comes_before(float min_x, int id, float other_min_x, int other_id)
+{
+    return min_x < other_min_x || (min_x == other_min_x && id < other_id);
+}
+
+SweepAndPrune::Box const SweepAndPrune::make_box(int id, glm::vec3 position, float width, float height)
+{
+    Box box;
+    box.min_x = position.x - width  / 2.0f;
+    box.max_x = position.x + width  / 2.0f;
+    box.min_y = position.y - height / 2.0f;
+    box.max_y = position.y + height / 2.0f;
+    box.id = id;
+    return box;
+}
+
+void SweepAndPrune::clear()
+{
+    m_boxes.clear();
+    m_slots.clear();
+    m_unsorted_count = 0;
+}
+
+void SweepAndPrune::insert(int id, glm::vec3 position, float width, float height)
+{
+    if (id >= (int) m_slots.size()) { m_slots.resize(id + 1, -1); }
+    if (m_slots[id] != -1) { move(id, position, width, height); return; }
+
+    // Appended out of order; the next sort moves it into place
+    m_slots[id] = (int) m_boxes.size();
+    m_boxes.push_back(make_box(id, position, width, height));
+    m_unsorted_count++;
+}
+
+void SweepAndPrune::move(int id, glm::vec3 position, float width, float height)
+{
+    if (id < 0 || id >= (int) m_slots.size() || m_slots[id] == -1) { return; }
+
+    m_boxes[m_slots[id]] = make_box(id, position, width, height);
+}
+
+void SweepAndPrune::remove(int id)
+{
+    if (id < 0 || id >= (int) m_slots.size() || m_slots[id] == -1) { return; }
+
+    // Erase in place so the rest of the array stays ordered
+    int slot = m_slots[id];
+    m_boxes.erase(m_boxes.begin() + slot);
+    m_slots[id] = -1;
+
+    for (int i = slot; i < (int) m_boxes.size(); i++) { m_slots[m_boxes[i].id] = i; }
+}
+
+void SweepAndPrune::sort_boxes()
+{
+    m_last_shift_count = 0;
+
+    if (m_unsorted_count > INSERTION_SORT_MAX_INSERTS)
+    {
+        std::sort(m_boxes.begin(), m_boxes.end(), [](const Box& a, const Box& b)
+                  { return comes_before(a.min_x, a.id, b.min_x, b.id); });
+        for (int i = 0; i < (int) m_boxes.size(); i++) { m_slots[m_boxes[i].id] = i; }
+    }
+    else
+    {
+        for (int i = 1; i < (int) m_boxes.size(); i++)
+        {
+            if (!comes_before(m_boxes[i].min_x, m_boxes[i].id, m_boxes[i - 1].min_x, m_boxes[i - 1].id)) { continue; }
+
+            Box box = m_boxes[i];
+            int slot = i;
+            while (slot > 0 && comes_before(box.min_x, box.id, m_boxes[slot - 1].min_x, m_boxes[slot - 1].id))
+            {
+                m_boxes[slot] = m_boxes[slot - 1];
+                m_slots[m_boxes[slot].id] = slot;
+                slot--;
+            }
+
+            m_boxes[slot] = box;
+            m_slots[box.id] = slot;
+            m_last_shift_count += i - slot;
+        }
+    }
+
+    m_unsorted_count = 0;
+}
+
+void SweepAndPrune::find_pairs(std::vector<OverlapPair>& out)
+{
+    PROFILE_ZONE("SweepAndPrune::find_pairs");
+
+    sort_boxes();
+
+    int box_count = (int) m_boxes.size();
+    for (int i = 0; i < box_count; i++)
+    {
+        const Box& box = m_boxes[i];
+
+        // Everything after i starts at or right of box.min_x; stop at the first that starts past its end
+        for (int j = i + 1; j < box_count && m_boxes[j].min_x <= box.max_x; j++)
+        {
+            const Box& other = m_boxes[j];
+            if (other.min_y > box.max_y || other.max_y < box.min_y) { continue; }
+
+            out.push_back(box.id < other.id ? OverlapPair { box.id, other.id } : OverlapPair { other.id, box.id });
+        }
+    }
+}
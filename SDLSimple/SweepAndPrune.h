@@ -0,0 +1,64 @@
+#ifndef SWEEP_AND_PRUNE_H
+#define SWEEP_AND_PRUNE_H
+
+#include <vector>
+#include "glm/glm.hpp"
+
+// Two ids whose boxes overlap, with a < b
+struct OverlapPair
+{
+    int a, b;
+};
+
+/**
+ * Sort-and-sweep broadphase for many moving boxes colliding with each other.
+ *
+ * Boxes are kept in one array ordered by their left edge. find_pairs() first
+ * restores that order with an insertion sort: bodies move a little each frame,
+ * so the array is nearly sorted already and the sort costs close to one pass
+ * instead of n log n. The sweep then walks the array, comparing each box only
+ * with those that start before it ends on x.
+ *
+ * The pairs it reports are candidates for the narrow phase (Entity::check_collision);
+ * the test here is inclusive so boxes that only touch are never dropped early.
+ * Static terrain belongs in StaticBvh, which is built once and never re-sorted.
+ */
+class SweepAndPrune
+{
+private:
+    struct Box
+    {
+        float min_x, max_x, min_y, max_y;
+        int id;
+    };
+
+    std::vector<Box> m_boxes;   // ordered by (min_x, id) after find_pairs()
+    std::vector<int> m_slots;   // id -> index into m_boxes, -1 when absent
+
+    int m_unsorted_count = 0;   // inserts since the last sort
+    int m_last_shift_count = 0;
+
+    static Box const make_box(int id, glm::vec3 position, float width, float height);
+    void sort_boxes();
+
+public:
+    // Past this many fresh inserts a full sort beats shifting each one into place
+    static constexpr int INSERTION_SORT_MAX_INSERTS = 64;
+
+    // ————— METHODS ————— //
+    void clear();
+
+    void insert(int id, glm::vec3 position, float width, float height);
+    // move and remove ignore ids that are not currently inserted
+    void move(int id, glm::vec3 position, float width, float height);
+    void remove(int id);
+
+    // Re-sorts on x and appends every pair whose boxes overlap on both axes
+    void find_pairs(std::vector<OverlapPair>& out);
+
+    // ————— GETTERS ————— //
+    int const get_box_count()        const { return (int) m_boxes.size(); }
+    int const get_last_shift_count() const { return m_last_shift_count; }   // insertion-sort moves in the last find_pairs()
+};
+
+#endif // SWEEP_AND_PRUNE_H
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cstring>
+#include "TextureAtlas.h"
+
+int AtlasBuilder::add(int width, int height, const unsigned char* pixels)
+{
+    m_sources.push_back({ width, height, pixels });
+    return (int) m_sources.size() - 1;
+}
+
+bool const AtlasBuilder::find_position(const Page& page, int width, int height, glm::ivec2& position) const
+{
+    bool found = false;
+
+    for (int i = 0; i < (int) page.skyline.size(); i++)
+    {
+        int x = page.skyline[i].x;
+        if (x + width > page.width) { break; }
+
+        // Resting height: the tallest segment under [x, x + width)
+        int y = 0;
+        for (int j = i; j < (int) page.skyline.size() && page.skyline[j].x < x + width; j++)
+        {
+            y = std::max(y, page.skyline[j].y);
+        }
+
+        if (y + height > page.height) { continue; }
+
+        // Bottom-left: lowest resting height, then leftmost
+        if (!found || y < position.y)
+        {
+            position = glm::ivec2(x, y);
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+void AtlasBuilder::place(Page& page, glm::ivec2 position, int width, int height)
+{
+    std::vector<glm::ivec3> skyline;
+    int right = position.x + width;
+
+    // Whatever sticks out left of the new segment, the new segment, then whatever sticks out right
+    for (const glm::ivec3& segment : page.skyline)
+    {
+        if (segment.x < position.x)
+        {
+            skyline.push_back(glm::ivec3(segment.x, segment.y, std::min(segment.x + segment.z, position.x) - segment.x));
+        }
+    }
+
+    skyline.push_back(glm::ivec3(position.x, position.y + height, width));
+
+    for (const glm::ivec3& segment : page.skyline)
+    {
+        int segment_right = segment.x + segment.z;
+        if (segment_right > right)
+        {
+            int left = std::max(segment.x, right);
+            skyline.push_back(glm::ivec3(left, segment.y, segment_right - left));
+        }
+    }
+
+    // Merge neighbours at the same height so later searches scan fewer segments
+    page.skyline.clear();
+    for (const glm::ivec3& segment : skyline)
+    {
+        if (!page.skyline.empty() && page.skyline.back().y == segment.y) { page.skyline.back().z += segment.z; }
+        else                                                             { page.skyline.push_back(segment); }
+    }
+}
+
+void AtlasBuilder::build()
+{
+    m_pages.clear();
+    m_regions.assign(m_sources.size(), AtlasRegion());
+
+    std::vector<int> order(m_sources.size());
+    for (int i = 0; i < (int) order.size(); i++) { order[i] = i; }
+    std::sort(order.begin(), order.end(), [this](int a, int b)
+    {
+        if (m_sources[a].height != m_sources[b].height) { return m_sources[a].height > m_sources[b].height; }
+        return m_sources[a].width > m_sources[b].width;
+    });
+
+    std::vector<glm::ivec2> positions(m_sources.size());
+
+    for (int index : order)
+    {
+        const Source& source = m_sources[index];
+        int padded_width  = source.width + m_padding;
+        int padded_height = source.height + m_padding;
+
+        int page_index = -1;
+        glm::ivec2 position;
+
+        if (padded_width > m_page_size || padded_height > m_page_size)
+        {
+            // Too big to share: a page of its own, exactly its size
+            m_pages.push_back({ source.width, source.height, {}, {} });
+            page_index = (int) m_pages.size() - 1;
+            position = glm::ivec2(0);
+            m_pages[page_index].skyline.push_back(glm::ivec3(0, source.height, source.width));
+        }
+        else
+        {
+            for (int i = 0; i < (int) m_pages.size() && page_index < 0; i++)
+            {
+                if (find_position(m_pages[i], padded_width, padded_height, position)) { page_index = i; }
+            }
+
+            if (page_index < 0)
+            {
+                m_pages.push_back({ m_page_size, m_page_size, {}, { glm::ivec3(0, 0, m_page_size) } });
+                page_index = (int) m_pages.size() - 1;
+                find_position(m_pages[page_index], padded_width, padded_height, position);
+            }
+
+            place(m_pages[page_index], position, padded_width, padded_height);
+        }
+
+        m_regions[index].page = page_index;
+        positions[index] = position;
+    }
+
+    // Trim each page to the rows it uses, then blit
+    for (Page& page : m_pages)
+    {
+        int used_height = 0;
+        for (const glm::ivec3& segment : page.skyline) { used_height = std::max(used_height, segment.y); }
+        page.height = std::min(std::max(used_height, 1), page.height);
+
+        page.pixels.assign((size_t) page.width * page.height * 4, 0);
+        page.skyline.clear();
+    }
+
+    for (int i = 0; i < (int) m_sources.size(); i++)
+    {
+        const Source& source = m_sources[i];
+        Page& page = m_pages[m_regions[i].page];
+        glm::ivec2 position = positions[i];
+
+        for (int row = 0; row < source.height; row++)
+        {
+            memcpy(&page.pixels[((size_t) (position.y + row) * page.width + position.x) * 4],
+                   &source.pixels[(size_t) row * source.width * 4], (size_t) source.width * 4);
+        }
+
+        m_regions[i].uv_rect = glm::vec4((float) position.x / page.width,
+                                         (float) position.y / page.height,
+                                         (float) (position.x + source.width) / page.width,
+                                         (float) (position.y + source.height) / page.height);
+    }
+
+    m_sources.clear();
+}
+
+void AtlasBuilder::release_pixels()
+{
+    for (Page& page : m_pages) { std::vector<unsigned char>().swap(page.pixels); }
+}
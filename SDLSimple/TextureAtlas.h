@@ -0,0 +1,80 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <vector>
+#include "glm/glm.hpp"
+
+constexpr int ATLAS_PAGE_SIZE = 2048;   // safe on every GL 2.1 driver we target
+constexpr int ATLAS_PADDING   = 1;      // transparent gutter between sprites
+
+// What an entity draws: the GL texture of its atlas page and the sub-rectangle
+// of that page it covers, as (u0, v0, u1, v1) with v0 at the top of the image
+struct AtlasSprite
+{
+    unsigned int page_texture_id = 0;
+    glm::vec4 uv_rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+};
+
+// Where the builder put one image
+struct AtlasRegion
+{
+    int page = -1;
+    glm::vec4 uv_rect = glm::vec4(0.0f);
+};
+
+/**
+ * Packs RGBA8 images into as few square pages as it can, with a skyline
+ * bottom-left packer over images sorted tallest first. An image larger than a
+ * page gets a page of its own, sized to fit.
+ *
+ * No GL here: build() produces page pixels and regions, and the caller uploads
+ * the pages and turns each region into an AtlasSprite.
+ */
+class AtlasBuilder
+{
+private:
+    struct Source
+    {
+        int width, height;
+        const unsigned char* pixels;
+    };
+
+    struct Page
+    {
+        int width, height;
+        std::vector<unsigned char> pixels;
+        std::vector<glm::ivec3> skyline;   // (x, y, width) segments, left to right
+    };
+
+    int m_page_size;
+    int m_padding;
+
+    std::vector<Source> m_sources;
+    std::vector<AtlasRegion> m_regions;
+    std::vector<Page> m_pages;
+
+    bool const find_position(const Page& page, int width, int height, glm::ivec2& position) const;
+    void place(Page& page, glm::ivec2 position, int width, int height);
+
+public:
+    AtlasBuilder(int page_size = ATLAS_PAGE_SIZE, int padding = ATLAS_PADDING)
+        : m_page_size(page_size), m_padding(padding) {}
+
+    // `pixels` must stay valid until build() returns. Returns the image's index.
+    int add(int width, int height, const unsigned char* pixels);
+
+    // Packs and copies every added image into pages
+    void build();
+
+    int const get_page_count() const { return (int) m_pages.size(); }
+    int const get_page_width(int page)  const { return m_pages[page].width;  }
+    int const get_page_height(int page) const { return m_pages[page].height; }
+    const unsigned char* get_page_pixels(int page) const { return m_pages[page].pixels.data(); }
+
+    const AtlasRegion& get_region(int index) const { return m_regions[index]; }
+
+    // Drops the page pixels once they are uploaded; regions stay valid
+    void release_pixels();
+};
+
+#endif // TEXTURE_ATLAS_H
@@ -0,0 +1,172 @@
+#define LOG(argument) std::cout << argument << '\n'
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "ImageDecodeQueue.h"
+#include "TexturePack.h"
+
+#ifdef _WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static uint64_t const align_up(uint64_t offset)
+{
+    return (offset + TEXTURE_PACK_ALIGNMENT - 1) / TEXTURE_PACK_ALIGNMENT * TEXTURE_PACK_ALIGNMENT;
+}
+
+bool cook_texture_pack(const std::vector<std::string>& filepaths, const char* output_path)
+{
+    std::vector<DecodedImage> images;
+    std::vector<TexturePackEntry> entries;
+
+    for (const std::string& filepath : filepaths)
+    {
+        if (filepath.size() >= TEXTURE_PACK_NAME_SIZE)
+        {
+            LOG("Skipping " << filepath << ": name longer than " << TEXTURE_PACK_NAME_SIZE - 1 << " characters");
+            continue;
+        }
+
+        DecodedImage image;
+        if (!decode_image_file(filepath.c_str(), image))
+        {
+            LOG("Skipping " << filepath << ": not an image stb can decode");
+            continue;
+        }
+
+        TexturePackEntry entry {};
+        strncpy(entry.name, filepath.c_str(), TEXTURE_PACK_NAME_SIZE - 1);
+        entry.width  = (uint32_t) image.width;
+        entry.height = (uint32_t) image.height;
+        entry.format = TEXTURE_FORMAT_RGBA8;
+
+        images.push_back(image);
+        entries.push_back(entry);
+    }
+
+    uint64_t offset = sizeof(TexturePackHeader) + entries.size() * sizeof(TexturePackEntry);
+    for (TexturePackEntry& entry : entries)
+    {
+        offset = align_up(offset);
+        entry.offset = offset;
+        offset += (uint64_t) entry.width * entry.height * 4;
+    }
+
+    std::ofstream outfile(output_path, std::ios::binary);
+    bool written = !outfile.fail();
+
+    if (written)
+    {
+        TexturePackHeader header {};
+        memcpy(header.magic, TEXTURE_PACK_MAGIC, sizeof(header.magic));
+        header.version = TEXTURE_PACK_VERSION;
+        header.entry_count = (uint32_t) entries.size();
+
+        outfile.write((const char*) &header, sizeof(header));
+        outfile.write((const char*) entries.data(), entries.size() * sizeof(TexturePackEntry));
+
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            static const char padding[TEXTURE_PACK_ALIGNMENT] = {};
+            outfile.write(padding, entries[i].offset - (uint64_t) outfile.tellp());
+            outfile.write((const char*) images[i].pixels, (std::streamsize) entries[i].width * entries[i].height * 4);
+        }
+
+        written = !outfile.fail();
+    }
+
+    if (!written) { LOG("Unable to write texture pack " << output_path); }
+    else          { LOG("Cooked " << entries.size() << " textures into " << output_path << " (" << offset << " bytes)"); }
+
+    for (DecodedImage& image : images) { free_decoded_image(image); }
+    return written;
+}
+
+bool TexturePack::open(const char* filepath)
+{
+    close();
+
+#ifdef _WINDOWS
+    m_file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) { m_file = nullptr; return false; }
+
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(m_file, &file_size);
+    m_size = (size_t) file_size.QuadPart;
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping != nullptr) { m_data = (const unsigned char*) MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0); }
+#else
+    int descriptor = ::open(filepath, O_RDONLY);
+    if (descriptor < 0) { return false; }
+
+    struct stat file_info;
+    if (fstat(descriptor, &file_info) == 0 && file_info.st_size > 0)
+    {
+        m_size = (size_t) file_info.st_size;
+        void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping != MAP_FAILED) { m_data = (const unsigned char*) mapping; }
+    }
+
+    // The mapping keeps the file alive on its own
+    ::close(descriptor);
+#endif
+
+    if (m_data == nullptr) { close(); return false; }
+
+    // Validate everything up front so lookups never have to
+    bool valid = m_size >= sizeof(TexturePackHeader)
+              && memcmp(header()->magic, TEXTURE_PACK_MAGIC, sizeof(TEXTURE_PACK_MAGIC)) == 0
+              && header()->version == TEXTURE_PACK_VERSION
+              && sizeof(TexturePackHeader) + (uint64_t) header()->entry_count * sizeof(TexturePackEntry) <= m_size;
+
+    for (uint32_t i = 0; valid && i < header()->entry_count; i++)
+    {
+        const TexturePackEntry& entry = entries()[i];
+        valid = entry.format == TEXTURE_FORMAT_RGBA8
+             && memchr(entry.name, '\0', TEXTURE_PACK_NAME_SIZE) != nullptr
+             && entry.offset + (uint64_t) entry.width * entry.height * 4 <= m_size;
+    }
+
+    if (!valid)
+    {
+        LOG("Texture pack " << filepath << " is malformed or from another version; ignoring it");
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void TexturePack::close()
+{
+#ifdef _WINDOWS
+    if (m_data != nullptr)    { UnmapViewOfFile(m_data); }
+    if (m_mapping != nullptr) { CloseHandle(m_mapping); }
+    if (m_file != nullptr)    { CloseHandle(m_file); }
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data != nullptr) { munmap((void*) m_data, m_size); }
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+const TexturePackEntry* TexturePack::find(const char* name) const
+{
+    // A handful to a few hundred entries: a linear scan over the mapped index is plenty
+    for (int i = 0; i < get_entry_count(); i++)
+    {
+        if (strcmp(entries()[i].name, name) == 0) { return &entries()[i]; }
+    }
+
+    return nullptr;
+}
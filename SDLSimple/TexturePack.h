@@ -0,0 +1,87 @@
+#ifndef TEXTURE_PACK_H
+#define TEXTURE_PACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Baked texture pack: every asset already decoded to RGBA8, so startup only
+ * maps the file and hands texel pointers straight to glTexImage2D.
+ *
+ *   TexturePackHeader
+ *   TexturePackEntry[entry_count]
+ *   texel blocks, each starting on a TEXTURE_PACK_ALIGNMENT boundary
+ *
+ * All integers are little-endian, which is every platform we ship on.
+ */
+constexpr char     TEXTURE_PACK_MAGIC[4]   = { 'L', 'P', 'A', 'K' };
+constexpr uint32_t TEXTURE_PACK_VERSION    = 1;
+constexpr int      TEXTURE_PACK_NAME_SIZE  = 56;
+constexpr uint64_t TEXTURE_PACK_ALIGNMENT  = 64;
+
+enum TexturePackFormat : uint32_t { TEXTURE_FORMAT_RGBA8 = 0 };
+
+struct TexturePackHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+};
+
+struct TexturePackEntry
+{
+    char name[TEXTURE_PACK_NAME_SIZE];   // NUL-terminated, e.g. "assets/player.png"
+    uint64_t offset;                     // from the start of the file
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;                     // TexturePackFormat
+    uint32_t reserved;
+};
+
+static_assert(sizeof(TexturePackHeader) == 16, "pack header layout is part of the file format");
+static_assert(sizeof(TexturePackEntry) == 80, "pack entry layout is part of the file format");
+
+// Decodes every image in `filepaths` and writes them to one pack, named by the
+// path exactly as given. Files stb cannot decode are skipped with a warning.
+bool cook_texture_pack(const std::vector<std::string>& filepaths, const char* output_path);
+
+/**
+ * Read-only view of a pack file, memory-mapped for the lifetime of the object.
+ * Texel pointers point into the mapping: no decode, no copy.
+ */
+class TexturePack
+{
+private:
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WINDOWS
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+
+    const TexturePackHeader* header() const { return (const TexturePackHeader*) m_data; }
+    const TexturePackEntry* entries() const { return (const TexturePackEntry*) (m_data + sizeof(TexturePackHeader)); }
+
+public:
+    TexturePack() = default;
+    ~TexturePack() { close(); }
+
+    TexturePack(const TexturePack&) = delete;
+    TexturePack& operator=(const TexturePack&) = delete;
+
+    // Maps and validates the pack; returns false (and stays closed) if it is missing or malformed
+    bool open(const char* filepath);
+    void close();
+
+    bool const is_open() const { return m_data != nullptr; }
+
+    const TexturePackEntry* find(const char* name) const;
+    const unsigned char* get_texels(const TexturePackEntry* entry) const { return m_data + entry->offset; }
+
+    int const get_entry_count() const { return is_open() ? (int) header()->entry_count : 0; }
+};
+
+#endif // TEXTURE_PACK_H
@@ -0,0 +1,147 @@
+#include "ThreadPool.h"
+
+// Index of the pool worker running on this thread, -1 everywhere else
+static thread_local int s_worker_index = -1;
+
+void ThreadPool::WorkerQueue::push_back(std::function<void()>&& task)
+{
+    if (count == tasks.size())
+    {
+        std::vector<std::function<void()>> grown(tasks.size() < 16 ? 16 : tasks.size() * 2);
+        for (size_t i = 0; i < count; i++) { grown[i] = std::move(tasks[(head + i) % tasks.size()]); }
+
+        tasks.swap(grown);
+        head = 0;
+    }
+
+    tasks[(head + count) % tasks.size()] = std::move(task);
+    count++;
+}
+
+void ThreadPool::WorkerQueue::pop_back(std::function<void()>& task)
+{
+    count--;
+    task = std::move(tasks[(head + count) % tasks.size()]);
+}
+
+void ThreadPool::WorkerQueue::pop_front(std::function<void()>& task)
+{
+    task = std::move(tasks[head]);
+    head = (head + 1) % tasks.size();
+    count--;
+}
+
+ThreadPool::ThreadPool(int thread_count)
+{
+    if (thread_count <= 0) { thread_count = (int) std::thread::hardware_concurrency(); }
+    if (thread_count <= 0) { thread_count = 1; }
+
+    for (int i = 0; i < thread_count; i++) { m_queues.push_back(std::make_unique<WorkerQueue>()); }
+    for (int i = 0; i < thread_count; i++) { m_threads.emplace_back(&ThreadPool::worker_loop, this, i); }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& thread : m_threads) { thread.join(); }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    // Tasks spawned by a worker stay on its own deque, where they are still cache-warm
+    int queue_index = s_worker_index >= 0 ? s_worker_index
+                                          : (int) (m_next_queue++ % m_queues.size());
+
+    m_pending++;
+    {
+        std::lock_guard<std::mutex> lock(m_queues[queue_index]->mutex);
+        m_queues[queue_index]->push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_queued++;
+    }
+    m_wake.notify_one();
+}
+
+bool ThreadPool::pop_or_steal(int worker_index, std::function<void()>& task)
+{
+    int queue_count = (int) m_queues.size();
+
+    // Own deque: newest first
+    {
+        WorkerQueue& own = *m_queues[worker_index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.count > 0)
+        {
+            own.pop_back(task);
+            m_queued--;
+            return true;
+        }
+    }
+
+    // Everyone else's: oldest first
+    for (int offset = 1; offset < queue_count; offset++)
+    {
+        WorkerQueue& victim = *m_queues[(worker_index + offset) % queue_count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.count > 0)
+        {
+            victim.pop_front(task);
+            m_queued--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::worker_loop(int worker_index)
+{
+    s_worker_index = worker_index;
+    std::function<void()> task;
+
+    while (true)
+    {
+        if (pop_or_steal(worker_index, task))
+        {
+            task();
+            task = nullptr;
+
+            if (--m_pending == 0)
+            {
+                std::lock_guard<std::mutex> lock(m_sleep_mutex);
+                m_done.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_wake.wait(lock, [this] { return m_stopping || m_queued > 0; });
+        if (m_stopping && m_queued == 0) { return; }
+    }
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(m_sleep_mutex);
+    m_done.wait(lock, [this] { return m_pending == 0; });
+}
+
+void ThreadPool::parallel_for(int count, int chunk_size, const std::function<void(int, int)>& body)
+{
+    if (chunk_size < 1) { chunk_size = 1; }
+
+    for (int begin = 0; begin < count; begin += chunk_size)
+    {
+        int end = begin + chunk_size < count ? begin + chunk_size : count;
+        submit([&body, begin, end] { body(begin, end); });
+    }
+
+    wait();
+}
@@ -0,0 +1,72 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed-size work-stealing thread pool.
+ *
+ * Every worker owns a task deque. A worker pops its own newest task first and,
+ * when it runs dry, steals the oldest task from another worker, so uneven
+ * batches (episodes that land early vs. ones that time out) still keep every
+ * core busy. Tasks submitted from outside the pool are dealt round-robin.
+ */
+class ThreadPool
+{
+private:
+    // Ring of tasks that only ever grows, so once it has reached its working size
+    // submitting a task that fits std::function's inline buffer allocates nothing
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::vector<std::function<void()>> tasks;
+        size_t head = 0;    // oldest task
+        size_t count = 0;
+
+        void push_back(std::function<void()>&& task);
+        void pop_back(std::function<void()>& task);
+        void pop_front(std::function<void()>& task);
+    };
+
+    std::vector<std::thread> m_threads;
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    std::atomic<int> m_queued { 0 };   // submitted, not yet picked up
+    std::atomic<int> m_pending { 0 };  // submitted, not yet finished
+    std::atomic<unsigned int> m_next_queue { 0 };
+    std::atomic<bool> m_stopping { false };
+
+    bool pop_or_steal(int worker_index, std::function<void()>& task);
+    void worker_loop(int worker_index);
+
+public:
+    // 0 threads means one per hardware thread
+    ThreadPool(int thread_count = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Blocks until every submitted task, including ones submitted by tasks, has finished.
+    // Only call from outside the pool; a worker waiting on itself never wakes up.
+    void wait();
+
+    // Splits [0, count) into chunks of `chunk_size` and runs body(begin, end) on each
+    void parallel_for(int count, int chunk_size, const std::function<void(int, int)>& body);
+
+    int const get_thread_count() const { return (int) m_threads.size(); }
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,58 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+/**
+ * Lock-free hand-off of the latest value from one writer thread to one reader
+ * thread. There are three slots: the writer fills its back slot, the reader
+ * holds its front slot, and the third sits in the middle. publish() swaps back
+ * and middle; acquire() swaps middle and front only if something new was
+ * published since the last acquire. Neither side ever waits for the other, and
+ * the reader always gets the newest complete value: values it is too slow for
+ * are simply skipped.
+ *
+ *   writer: buffer.back() = value; buffer.publish();
+ *   reader: const T& newest = buffer.acquire();
+ *
+ * A slot the reader holds stays untouched until its next acquire().
+ */
+template <typename T>
+class TripleBuffer
+{
+private:
+    static constexpr unsigned int INDEX_MASK = 3;
+    static constexpr unsigned int FRESH_BIT  = 4;   // set on the middle index by publish(), cleared by acquire()
+
+    T m_slots[3];
+
+    // Kept off the slots' cache lines so the two threads only share this word
+    alignas(64) std::atomic<unsigned int> m_middle { 1 };
+    alignas(64) unsigned int m_back = 0;    // writer only
+    alignas(64) unsigned int m_front = 2;   // reader only
+
+public:
+    // Writer: the slot to fill before the next publish()
+    T& back() { return m_slots[m_back]; }
+
+    void publish()
+    {
+        // Release: the slot's contents become visible with the index
+        m_back = m_middle.exchange(m_back | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader: whether acquire() would return something new
+    bool const has_fresh() const { return (m_middle.load(std::memory_order_relaxed) & FRESH_BIT) != 0; }
+
+    // Reader: the newest published value, or the same one again if nothing new arrived
+    const T& acquire()
+    {
+        if (m_middle.load(std::memory_order_relaxed) & FRESH_BIT)
+        {
+            m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return m_slots[m_front];
+    }
+};
+
+#endif // TRIPLE_BUFFER_H
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cmath>
+#include "UniformGrid.h"
+
+UniformGrid::UniformGrid(float cell_size)
+{
+    m_cell_size = cell_size;
+    m_inverse_cell_size = 1.0f / cell_size;
+}
+
+void UniformGrid::clear()
+{
+    m_cells.clear();
+    m_ranges.clear();
+}
+
+long long const UniformGrid::cell_key(int cell_x, int cell_y)
+{
+    return ((long long) cell_x << 32) | (unsigned int) cell_y;
+}
+
+UniformGrid::CellRange const UniformGrid::cell_range(glm::vec3 position, float width, float height) const
+{
+    CellRange range;
+    range.min_x = (int) floorf((position.x - width  / 2.0f) * m_inverse_cell_size);
+    range.min_y = (int) floorf((position.y - height / 2.0f) * m_inverse_cell_size);
+    range.max_x = (int) floorf((position.x + width  / 2.0f) * m_inverse_cell_size);
+    range.max_y = (int) floorf((position.y + height / 2.0f) * m_inverse_cell_size);
+    range.in_use = true;
+    return range;
+}
+
+void UniformGrid::add_to_cells(int id, const CellRange& range)
+{
+    for (int cell_y = range.min_y; cell_y <= range.max_y; cell_y++)
+    {
+        for (int cell_x = range.min_x; cell_x <= range.max_x; cell_x++)
+        {
+            m_cells[cell_key(cell_x, cell_y)].push_back(id);
+        }
+    }
+}
+
+void UniformGrid::remove_from_cells(int id, const CellRange& range)
+{
+    for (int cell_y = range.min_y; cell_y <= range.max_y; cell_y++)
+    {
+        for (int cell_x = range.min_x; cell_x <= range.max_x; cell_x++)
+        {
+            auto cell = m_cells.find(cell_key(cell_x, cell_y));
+            if (cell == m_cells.end()) { continue; }
+
+            std::vector<int>& ids = cell->second;
+            auto found = std::find(ids.begin(), ids.end(), id);
+            if (found != ids.end())
+            {
+                *found = ids.back();
+                ids.pop_back();
+            }
+            if (ids.empty()) { m_cells.erase(cell); }
+        }
+    }
+}
+
+void UniformGrid::insert(int id, glm::vec3 position, float width, float height)
+{
+    if (id >= (int) m_ranges.size()) { m_ranges.resize(id + 1, CellRange { 0, 0, 0, 0, false }); }
+    if (m_ranges[id].in_use) { remove_from_cells(id, m_ranges[id]); }
+
+    m_ranges[id] = cell_range(position, width, height);
+    add_to_cells(id, m_ranges[id]);
+}
+
+void UniformGrid::move(int id, glm::vec3 position, float width, float height)
+{
+    if (id >= (int) m_ranges.size() || !m_ranges[id].in_use)
+    {
+        insert(id, position, width, height);
+        return;
+    }
+
+    CellRange range = cell_range(position, width, height);
+    const CellRange& old_range = m_ranges[id];
+
+    // Most frames a mover stays inside the same cells, so there is nothing to do
+    if (range.min_x == old_range.min_x && range.min_y == old_range.min_y &&
+        range.max_x == old_range.max_x && range.max_y == old_range.max_y) { return; }
+
+    remove_from_cells(id, old_range);
+    m_ranges[id] = range;
+    add_to_cells(id, range);
+}
+
+void UniformGrid::remove(int id)
+{
+    if (id >= (int) m_ranges.size() || !m_ranges[id].in_use) { return; }
+
+    remove_from_cells(id, m_ranges[id]);
+    m_ranges[id].in_use = false;
+}
+
+void UniformGrid::query(glm::vec3 position, float width, float height, std::vector<int>& out) const
+{
+    size_t first = out.size();
+    CellRange range = cell_range(position, width, height);
+
+    for (int cell_y = range.min_y; cell_y <= range.max_y; cell_y++)
+    {
+        for (int cell_x = range.min_x; cell_x <= range.max_x; cell_x++)
+        {
+            auto cell = m_cells.find(cell_key(cell_x, cell_y));
+            if (cell == m_cells.end()) { continue; }
+
+            out.insert(out.end(), cell->second.begin(), cell->second.end());
+        }
+    }
+
+    // Boxes that straddle a cell border show up once per cell
+    std::sort(out.begin() + first, out.end());
+    out.erase(std::unique(out.begin() + first, out.end()), out.end());
+}
@@ -0,0 +1,64 @@
+#ifndef UNIFORM_GRID_H
+#define UNIFORM_GRID_H
+
+#include <unordered_map>
+#include <vector>
+#include "glm/glm.hpp"
+#include "Broadphase.h"
+
+/**
+ * Uniform-grid broadphase over axis-aligned boxes.
+ *
+ * Each box is bucketed into every square cell it overlaps, keyed by the packed
+ * (cell x, cell y) pair. Static platforms are inserted once after the level is
+ * built; anything that moves calls move(), which only touches the buckets when
+ * the box actually crosses into a different range of cells.
+ *
+ * The level's platforms are static, so the game queries StaticBvh instead and
+ * this grid is no longer part of lunar_sim. It is built into lunar_headless as
+ * the --bench-broadphase baseline; reach for it again only if the simulation
+ * gains many similar-sized boxes that move every step, where refitting a BVH
+ * costs more than re-bucketing.
+ */
+class UniformGrid : public Broadphase
+{
+private:
+    struct CellRange
+    {
+        int min_x, min_y, max_x, max_y;
+        bool in_use;
+    };
+
+    float m_cell_size;
+    float m_inverse_cell_size;
+
+    std::unordered_map<long long, std::vector<int>> m_cells;
+    std::vector<CellRange> m_ranges;
+
+    CellRange const cell_range(glm::vec3 position, float width, float height) const;
+    static long long const cell_key(int cell_x, int cell_y);
+
+    void add_to_cells(int id, const CellRange& range);
+    void remove_from_cells(int id, const CellRange& range);
+
+public:
+    static constexpr float DEFAULT_CELL_SIZE = 1.0f;
+
+    // ————— METHODS ————— //
+    UniformGrid(float cell_size = DEFAULT_CELL_SIZE);
+
+    void clear();
+
+    void insert(int id, glm::vec3 position, float width, float height);
+    void move(int id, glm::vec3 position, float width, float height);
+    void remove(int id);
+
+    // Appends the ids of every box sharing a cell with the query box
+    void query(glm::vec3 position, float width, float height, std::vector<int>& out) const override;
+
+    // ————— GETTERS ————— //
+    float const get_cell_size()  const { return m_cell_size; }
+    int   const get_cell_count() const { return (int) m_cells.size(); }
+};
+
+#endif // UNIFORM_GRID_H
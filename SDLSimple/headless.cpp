@@ -0,0 +1,345 @@
+/**
+* lunar_headless: steps the lander simulation with no window, GL context or
+* vsync, driven by a scripted input file instead of the keyboard.
+*
+*   lunar_headless [--script FILE] [--episodes N] [--max-frames N]
+*                  [--batch N [--threads T] [--seed S] [--outcomes FILE]]
+*                  [--dt-scale K] [--swept]
+*                  [--bench-broadphase] [--bench-pool] [--bench-textures]
+*                  [--cook-pack DIR OUT] [--trace FILE [--trace-frames N]]
+*                  [--replay FILE [--repeat N]] [--bench-restart]
+*                  [--bench-vecenv K] [--bench-sap] [--bench-integrate]
+*                  [--bench-pacer] [--test-aabb] [--test-swept]
+*
+* --batch runs N randomised episodes (own Rng per episode: target platform,
+* start x and gravity) on 1, 2, 4 ... T threads, reports episodes/sec at each
+* thread count and writes per-episode outcomes as CSV.
+*
+* --dt-scale steps K * FIXED_TIMESTEP at a time; --swept switches the lander to
+* swept collisions so those larger steps cannot tunnel through platforms.
+*
+* --cook-pack decodes every image in DIR into one baked texture pack at OUT;
+* run it from the game's working directory so entry names match its asset paths.
+*
+* --replay steps a session saved by the game's --record as fast as possible,
+* N times over, and prints where it ended: a reproducible production workload.
+*
+* --bench-vecenv steps K landers in lockstep through LanderVecEnv under a
+* simple steering policy and reports env-steps/sec at 1, 2, 4 ... threads.
+*
+* --test-* run a self-check and exit 1 on the first mismatch: --test-aabb holds
+* every compiled AABB batch kernel (AVX, SSE2, scalar) against check_collision;
+* --test-swept drives SWEPT landers at large steps into thin platforms and corners.
+*
+* --bench-broadphase also exits 1 when the linear scan, grid and BVH find
+* different contacts; --bench-textures when pack texels differ from stb_image's
+* decode; --bench-restart when a restore or rewind does not reproduce the state;
+* --bench-integrate when integrate_bodies and Entity::update disagree.
+*
+* --trace records profiler zones and writes the last N steps (default 300) as
+* Chrome trace_event JSON, viewable in Perfetto or chrome://tracing.
+*
+* A script is a text file of "<frames> <keys>" lines, where keys is any mix of
+* L, R, U and D (or "-" for none), e.g. "90 -" then "30 UL". Once the script
+* runs out the lander coasts with no input.
+**/
+#define LOG(argument) std::cout << argument << '\n'
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "GameState.h"
+#include "BatchRunner.h"
+#include "Benchmarks.h"
+#include "SelfTests.h"
+#include "TexturePack.h"
+#include "Profiler.h"
+#include "InputRecording.h"
+
+constexpr int DEFAULT_EPISODES   = 1000;
+constexpr int DEFAULT_MAX_FRAMES = 60 * 60;
+constexpr int DEFAULT_TRACE_FRAMES = 300;
+
+void write_outcomes(const char* filepath, const std::vector<EpisodeResult>& results)
+{
+    std::ofstream outfile(filepath);
+
+    if (outfile.fail())
+    {
+        LOG("Unable to write outcomes to " << filepath);
+        return;
+    }
+
+    outfile << "seed,target_index,start_x,gravity,outcome,frames,time_to_touchdown\n";
+    for (const EpisodeResult& result : results)
+    {
+        const char* outcome = result.outcome == HITTARGET ? "HITTARGET"
+                            : result.outcome == GROUND    ? "GROUND" : "TIMEOUT";
+
+        outfile << result.seed << ',' << result.target_index << ',' << result.start_x << ','
+                << result.gravity << ',' << outcome << ',' << result.frames << ','
+                << result.time_to_touchdown << '\n';
+    }
+}
+
+void run_batch(int episode_count, int max_threads, unsigned long long seed, int max_frames,
+               float delta_time, CollisionMode collision_mode,
+               const std::vector<unsigned char>& script, const char* outcomes_path)
+{
+    std::vector<EpisodeResult> results(episode_count);
+
+    LOG("threads    episodes / sec    frames / sec    scaling");
+    double single_thread_rate = 0.0;
+
+    for (int thread_count = 1; ; thread_count = std::min(thread_count * 2, max_threads))
+    {
+        ThreadPool pool(thread_count);
+
+        auto start = std::chrono::steady_clock::now();
+        run_episodes(pool, seed, episode_count, max_frames, script, results.data(), delta_time, collision_mode);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        long long frames = 0;
+        for (const EpisodeResult& result : results) { frames += result.frames; }
+
+        double rate = episode_count / seconds;
+        if (thread_count == 1) { single_thread_rate = rate; }
+
+        LOG(thread_count << "\t\t" << rate << "\t\t" << frames / seconds << "\t\t"
+            << rate / single_thread_rate << "x");
+
+        if (thread_count == max_threads) { break; }
+    }
+
+    int wins = 0, losses = 0;
+    for (const EpisodeResult& result : results)
+    {
+        if      (result.outcome == HITTARGET) { wins++; }
+        else if (result.outcome == GROUND)    { losses++; }
+    }
+    LOG("outcomes: " << wins << " HITTARGET, " << losses << " GROUND, "
+                     << episode_count - wins - losses << " timed out");
+
+    if (outcomes_path != nullptr) { write_outcomes(outcomes_path, results); }
+}
+
+void write_trace(const char* filepath, int frame_count)
+{
+    if (profiler_write_chrome_trace(filepath, frame_count)) { LOG("Wrote trace to " << filepath); }
+    else                                                    { LOG("Unable to write trace to " << filepath); }
+}
+
+int run_replay(const char* filepath, int repeats, CollisionMode collision_mode)
+{
+    InputRecording recording;
+    if (!load_input_recording(filepath, recording))
+    {
+        LOG("Unable to load replay " << filepath);
+        return 1;
+    }
+
+    GameState state;
+    state.collision_mode = collision_mode;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int repeat = 0; repeat < repeats; repeat++)
+    {
+        seed_game_state(state, recording.seed);
+
+        // Every recorded step, including the ones after touchdown, exactly as the game ran them
+        for (unsigned char input : recording.inputs)
+        {
+            profiler_mark_frame();
+            apply_input(state, input);
+            step_game_state(state, recording.delta_time);
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long long total_steps = (long long) recording.inputs.size() * repeats;
+    glm::vec3 position = state.player.get_position();
+
+    LOG("replay:        " << recording.inputs.size() << " steps, seed " << recording.seed << ", target " << state.target_index);
+    LOG("outcome:       " << (!state.game_over ? "in flight" : state.game_win ? "HITTARGET" : "GROUND"));
+    LOG("ended at:      (" << position.x << ", " << position.y << ")");
+    LOG("steps / sec:   " << (seconds > 0.0 ? total_steps / seconds : 0.0) << " over " << repeats << " run(s)");
+
+    return 0;
+}
+
+int cook_pack(const char* directory, const char* output_path)
+{
+    std::vector<std::string> filepaths;
+    std::error_code error;
+
+    for (const auto& item : std::filesystem::directory_iterator(directory, error))
+    {
+        if (!item.is_regular_file() || item.path().filename().string()[0] == '.') { continue; }
+        if (item.path() == std::filesystem::path(output_path)) { continue; }
+
+        // Names are "DIR/file" with forward slashes, exactly what the game passes to load_texture
+        filepaths.push_back(std::string(directory) + "/" + item.path().filename().string());
+    }
+
+    if (error)
+    {
+        LOG("Unable to read " << directory << ": " << error.message());
+        return 1;
+    }
+
+    std::sort(filepaths.begin(), filepaths.end());
+    return cook_texture_pack(filepaths, output_path) ? 0 : 1;
+}
+
+std::vector<unsigned char> load_script(const char* filepath)
+{
+    std::vector<unsigned char> inputs;
+    std::ifstream infile(filepath);
+
+    if (infile.fail())
+    {
+        LOG("Unable to open script " << filepath);
+        return inputs;
+    }
+
+    int frames;
+    std::string keys;
+    while (infile >> frames >> keys)
+    {
+        unsigned char input = 0;
+        for (char key : keys)
+        {
+            switch (key) {
+            case 'L': input |= INPUT_LEFT;  break;
+            case 'R': input |= INPUT_RIGHT; break;
+            case 'U': input |= INPUT_UP;    break;
+            case 'D': input |= INPUT_DOWN;  break;
+            default: break;
+            }
+        }
+        inputs.insert(inputs.end(), frames, input);
+    }
+
+    return inputs;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* script_path = nullptr;
+    int episodes   = DEFAULT_EPISODES;
+    int max_frames = DEFAULT_MAX_FRAMES;
+    float delta_time = FIXED_TIMESTEP;
+    CollisionMode collision_mode = DISCRETE;
+
+    int batch_episodes = 0;
+    int max_threads = (int) std::thread::hardware_concurrency();
+    unsigned long long seed = 1;
+    const char* outcomes_path = nullptr;
+    const char* trace_path = nullptr;
+    const char* replay_path = nullptr;
+    int replay_repeats = 1;
+    int trace_frames = DEFAULT_TRACE_FRAMES;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if      (strcmp(argv[i], "--script") == 0 && i + 1 < argc)     { script_path = argv[++i]; }
+        else if (strcmp(argv[i], "--episodes") == 0 && i + 1 < argc)   { episodes = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--max-frames") == 0 && i + 1 < argc) { max_frames = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--dt-scale") == 0 && i + 1 < argc)   { delta_time = FIXED_TIMESTEP * atof(argv[++i]); }
+        else if (strcmp(argv[i], "--swept") == 0)                      { collision_mode = SWEPT; }
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)      { batch_episodes = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)    { max_threads = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)       { seed = strtoull(argv[++i], nullptr, 10); }
+        else if (strcmp(argv[i], "--outcomes") == 0 && i + 1 < argc)   { outcomes_path = argv[++i]; }
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)      { trace_path = argv[++i]; }
+        else if (strcmp(argv[i], "--trace-frames") == 0 && i + 1 < argc) { trace_frames = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)     { replay_path = argv[++i]; }
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)     { replay_repeats = std::max(atoi(argv[++i]), 1); }
+        else if (strcmp(argv[i], "--bench-broadphase") == 0)           { return run_broadphase_benchmark() ? 0 : 1; }
+        else if (strcmp(argv[i], "--bench-sap") == 0)                  { run_sweep_and_prune_benchmark(); return 0; }
+        else if (strcmp(argv[i], "--bench-integrate") == 0)            { return run_integrator_benchmark() ? 0 : 1; }
+        else if (strcmp(argv[i], "--bench-pool") == 0)                 { run_pool_benchmark(); return 0; }
+        else if (strcmp(argv[i], "--bench-textures") == 0)             { return run_texture_decode_benchmark() ? 0 : 1; }
+        else if (strcmp(argv[i], "--bench-restart") == 0)              { return run_restart_benchmark() ? 0 : 1; }
+        else if (strcmp(argv[i], "--bench-pacer") == 0)                { run_frame_pacer_benchmark(); return 0; }
+        else if (strcmp(argv[i], "--bench-vecenv") == 0 && i + 1 < argc) { run_vec_env_benchmark(std::max(atoi(argv[++i]), 1)); return 0; }
+        else if (strcmp(argv[i], "--test-aabb") == 0)                  { return run_aabb_self_test() ? 0 : 1; }
+        else if (strcmp(argv[i], "--test-swept") == 0)                 { return run_swept_self_test() ? 0 : 1; }
+        else if (strcmp(argv[i], "--cook-pack") == 0 && i + 2 < argc)  { return cook_pack(argv[i + 1], argv[i + 2]); }
+        else
+        {
+            LOG("Unknown argument " << argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<unsigned char> script;
+    if (script_path != nullptr) { script = load_script(script_path); }
+
+    if (trace_path != nullptr)
+    {
+        profiler_set_enabled(true);
+        profiler_set_thread_name("main");
+    }
+
+    if (replay_path != nullptr)
+    {
+        int status = run_replay(replay_path, replay_repeats, collision_mode);
+        if (trace_path != nullptr) { write_trace(trace_path, trace_frames); }
+        return status;
+    }
+
+    if (batch_episodes > 0)
+    {
+        run_batch(batch_episodes, std::max(max_threads, 1), seed, max_frames, delta_time, collision_mode,
+                  script, outcomes_path);
+        if (trace_path != nullptr) { write_trace(trace_path, trace_frames); }
+        return 0;
+    }
+
+    GameState state;
+    state.collision_mode = collision_mode;
+    long long total_frames = 0;
+    int wins = 0, losses = 0, timeouts = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int episode = 0; episode < episodes; episode++)
+    {
+        initialise_game_state(state, episode % PLATFORM_COUNT);
+
+        int frame = 0;
+        while (!state.game_over && frame < max_frames)
+        {
+            profiler_mark_frame();
+            apply_input(state, frame < (int) script.size() ? script[frame] : 0);
+            step_game_state(state, delta_time);
+            frame++;
+        }
+
+        total_frames += frame;
+        if (!state.game_over)   { timeouts++; }
+        else if (state.game_win) { wins++; }
+        else                     { losses++; }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    LOG("episodes:      " << episodes << " (" << wins << " HITTARGET, " << losses << " GROUND, "
+                          << timeouts << " timed out)");
+    LOG("frames:        " << total_frames);
+    LOG("wall time:     " << seconds << " s");
+    LOG("frames / sec:  " << (seconds > 0.0 ? total_frames / seconds : 0.0));
+
+    if (trace_path != nullptr) { write_trace(trace_path, trace_frames); }
+
+    return 0;
+}
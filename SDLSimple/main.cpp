@@ -8,10 +8,8 @@
 * Academic Misconduct.
 **/
 #define GL_SILENCE_DEPRECATION
-#define STB_IMAGE_IMPLEMENTATION
 #define LOG(argument) std::cout << argument << '\n'
 #define GL_GLEXT_PROTOTYPES 1
-#define FIXED_TIMESTEP 0.0166666f
 
 #ifdef _WINDOWS
 #include <GL/glew.h>
@@ -22,19 +20,30 @@
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "ShaderProgram.h"
-#include "stb_image.h"
+#include "SpriteBatch.h"
+#include "InstancedQuads.h"
+#include "GLStateCache.h"
 #include "cmath"
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <ctime>
+#include <string>
+#include <thread>
 #include <vector>
 #include "Entity.h"
-
-struct GameState
-{
-    Entity* player;
-    Entity* platforms;
-    Entity* game_lost;
-    Entity* game_won;
-};
+#include "GameState.h"
+#include "ImageDecodeQueue.h"
+#include "TexturePack.h"
+#include "TextureAtlas.h"
+#include "Profiler.h"
+#include "InputRecording.h"
+#include "SnapshotRing.h"
+#include "TripleBuffer.h"
+#include "FramePacer.h"
+#include "OffscreenTarget.h"
+#include "GoldenImage.h"
+#include "Rng.h"
 
 constexpr int WINDOW_WIDTH  = 640,
               WINDOW_HEIGHT = 480;
@@ -50,17 +59,35 @@ constexpr int VIEWPORT_X = 0,
               VIEWPORT_HEIGHT = WINDOW_HEIGHT;
 
 constexpr char V_SHADER_PATH[] = "shaders/vertex_textured.glsl",
-               F_SHADER_PATH[] = "shaders/fragment_textured.glsl";
+               F_SHADER_PATH[] = "shaders/fragment_textured.glsl",
+               V_INSTANCED_SHADER_PATH[] = "shaders/vertex_textured_instanced.glsl";
 
-constexpr float MILLISECONDS_IN_SECOND = 1000.0;
+// A hitch longer than this many steps is dropped rather than simulated, so one
+// slow frame cannot snowball into ever longer catch-up frames
+constexpr int MAX_STEPS_PER_FRAME = 5;
 constexpr char SPRITESHEET_FILEPATH[] = "assets/player.png",
                PLATFORM_FILEPATH[]    = "assets/platform.png",
                TARGET_FILEPATH[]      = "assets/wintile.png",
                GAME_WON_FILEPATH[]    = "assets/missioncomplete.png",
                GAME_FAIL_FILEPATH[]   = "assets/missionfailed.png";
+constexpr char TEXTURE_PACK_FILEPATH[] = "assets/textures.pack";
+
+// Linked shader binaries, reused across launches; --shader-cache DIR moves it, --no-shader-cache turns it off
+constexpr char DEFAULT_SHADER_CACHE_DIRECTORY[] = "shader_cache";
 
-constexpr int PLATFORM_COUNT = 10;
-float g_gravity = -4.0f;
+// --trace keeps this many frames unless --trace-frames says otherwise
+constexpr int DEFAULT_TRACE_FRAMES = 300;
+
+// --fps overrides the frame cap (0: uncapped); pacing stats are logged this often
+constexpr float DEFAULT_TARGET_FPS = 60.0f;
+constexpr double FRAME_STATS_INTERVAL_SECONDS = 5.0;
+
+// Offscreen runs lay out this level unless replaying, so goldens stay comparable
+constexpr unsigned long long OFFSCREEN_SEED = 1;
+constexpr int DEFAULT_GOLDEN_STEPS = 60;
+constexpr int GOLDEN_TOLERANCE     = 2;      // per channel, for rounding differences between drivers
+constexpr int BENCH_RENDER_WARMUP_FRAMES = 30,
+              BENCH_RENDER_FRAMES        = 600;
 
 constexpr int NUMBER_OF_TEXTURES = 1;
 constexpr GLint LEVEL_OF_DETAIL  = 0;
@@ -68,59 +95,204 @@ constexpr GLint TEXTURE_BORDER   = 0;
 
 GameState g_game_state;
 
-SDL_Window* g_display_window;
-bool g_game_is_running = true;
+// Dynamic state right after the level was laid out (R restarts from it) and a
+// snapshot per fixed step for rewinding (hold Backspace)
+SimState g_level_start;
+SnapshotRing g_rewind;
+std::atomic<bool> g_rewinding { false };
+Entity* g_game_lost;
+Entity* g_game_won;
 
-bool g_game_win = false;
-bool g_game_over = false;
+// Cooked with `lunar_headless --cook-pack assets assets/textures.pack`; optional
+TexturePack g_texture_pack;
+
+SDL_Window* g_display_window;
+std::atomic<bool> g_game_is_running { true };
 
 ShaderProgram g_shader_program;
+SpriteBatch g_sprite_batch;
+
+// Platforms never move, so they are uploaded once and drawn instanced.
+// --tile-field N adds N background tiles to the same draw as a stress test.
+ShaderProgram g_instanced_program;
+InstancedQuads g_static_quads;
+int g_tile_field_count = 0;
+int g_last_draw_calls = -1;
 glm::mat4 g_view_matrix, g_projection_matrix;
 
-float g_previous_ticks = 0.0f;
-float g_time_accumulator = 0.0f;
+// The render loop sleeps between frames instead of spinning. With --on-demand it
+// also skips frames where nothing changed: game over, paused (P), or idle.
+FramePacer g_frame_pacer(DEFAULT_TARGET_FPS);
+bool g_on_demand = false;
+bool g_redraw_requested = true;     // window exposed or resized: the last frame is gone
+int g_rendered_frames = 0;
+uint64_t g_frame_stats_start_ns = 0;
+
+// ————— OFFSCREEN ————— //
+// --offscreen draws into an FBO behind a hidden window (SDL's offscreen video
+// driver where there is one, e.g. llvmpipe over EGL on a CI box) and steps the
+// simulation on the main thread off the wall clock, so frames are reproducible.
+// --golden FILE checks the frame after --golden-steps N steps against FILE
+// (--update-golden writes it instead); --bench-render N times render() with N
+// extra landers on screen. Both imply --offscreen.
+//
+// goldens/ holds frames rendered by Mesa's llvmpipe; from this directory, check them with
+//   LIBGL_ALWAYS_SOFTWARE=1 ./SDLSimple --golden goldens/step60.png
+//   LIBGL_ALWAYS_SOFTWARE=1 ./SDLSimple --golden goldens/step600.png --golden-steps 600
+// and add --update-golden to either after a change that is meant to alter the picture.
+bool g_offscreen = false;
+OffscreenTarget g_offscreen_target;
+const char* g_golden_path = nullptr;
+bool g_update_golden = false;
+int g_golden_steps = DEFAULT_GOLDEN_STEPS;
+int g_bench_render_count = -1;
+std::vector<Entity> g_bench_entities;
+
+const char* g_trace_path = nullptr;
+int g_trace_frames = DEFAULT_TRACE_FRAMES;
+
+const char* g_shader_cache_directory = DEFAULT_SHADER_CACHE_DIRECTORY;
+
+// Time to first frame runs from the start of initialise() to the first frame the GPU has finished
+Uint64 g_launch_counter = 0;
+bool g_first_frame_reported = false;
+
+// --record FILE saves this session's seed and per-step inputs on exit;
+// --replay FILE plays a saved session back through the fixed-step loop instead of the keyboard
+const char* g_record_path = nullptr;
+const char* g_replay_path = nullptr;
+InputRecording g_recording;
+size_t g_replay_step = 0;
+
+// Keyboard state sampled by the render thread's latest frame, applied on every fixed step until the next one
+std::atomic<unsigned char> g_frame_input { 0 };
+
+// ————— SIMULATION THREAD ————— //
+// g_game_state, g_rewind and g_recording belong to the simulation thread while
+// it runs; the render thread only ever sees RenderSnapshots and the flags above.
+struct RenderSnapshot
+{
+    Entity player;              // trivially copyable: position, previous position and sprite
+    bool game_over = false;
+    bool game_win = false;
+    float time_accumulator = 0.0f;
+    Uint64 counter = 0;         // when it was published, to keep interpolating past it
+};
+
+TripleBuffer<RenderSnapshot> g_snapshots;
+std::atomic<bool> g_restart_requested { false };
+std::atomic<bool> g_paused { false };
+std::thread g_sim_thread;
+
+Uint64 g_previous_counter = 0;
 
 void initialise();
+void restart();
 void process_input();
 void update();
+void publish_snapshot();
+void simulate();
 void render();
+void log_frame_stats();
+int run_offscreen();
 void shutdown();
 
-GLuint load_texture(const char* filepath)
+// Must run on the thread that owns the GL context
+GLuint upload_texture(const unsigned char* pixels, int width, int height)
 {
-    int width, height, number_of_components;
-    unsigned char* image = stbi_load(filepath, &width, &height, &number_of_components, STBI_rgb_alpha);
-    
-    if (image == NULL)
-    {
-        LOG("Unable to load image. Make sure the path is correct.");
-        assert(false);
-    }
-    
     GLuint textureID;
     glGenTextures(NUMBER_OF_TEXTURES, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA, width, height, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, image);
+    GLStateCache::get().bind_texture(0, textureID);
+    glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA, width, height, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
     
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    
-    stbi_image_free(image);
+    // Atlas pages: sprites are sub-rectangles, so repeating would sample a neighbour
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     
     return textureID;
 };
 
+// `names` are texture pack entries or, failing that, image file paths. Pack
+// entries are read straight from the mapping and everything else is decoded in
+// parallel; then the lot is packed into atlas pages and each page is uploaded
+// once, so the whole scene shares as few texture binds as possible.
+void load_sprites(const char* const names[], AtlasSprite sprites[], int count)
+{
+    ThreadPool pool;
+    ImageDecodeQueue decodes(pool);
+    AtlasBuilder atlas;
+
+    std::vector<int> atlas_index(count);
+    std::vector<int> slot_owners;
+    std::vector<DecodedImage> decoded;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (const TexturePackEntry* entry = g_texture_pack.find(names[i]))
+        {
+            atlas_index[i] = atlas.add(entry->width, entry->height, g_texture_pack.get_texels(entry));
+            continue;
+        }
+
+        decodes.request(names[i]);
+        slot_owners.push_back(i);
+    }
+
+    DecodedImage image;
+    while (decodes.wait_next(image))
+    {
+        int owner = slot_owners[image.slot];
+        if (image.pixels == nullptr)
+        {
+            LOG("Unable to load image " << names[owner] << ". Make sure the path is correct.");
+            assert(false);
+        }
+
+        atlas_index[owner] = atlas.add(image.width, image.height, image.pixels);
+        decoded.push_back(image);
+    }
+
+    atlas.build();
+
+    std::vector<GLuint> page_texture_ids;
+    for (int page = 0; page < atlas.get_page_count(); page++)
+    {
+        page_texture_ids.push_back(upload_texture(atlas.get_page_pixels(page),
+                                                  atlas.get_page_width(page), atlas.get_page_height(page)));
+    }
+    atlas.release_pixels();
+
+    for (DecodedImage& image : decoded) { free_decoded_image(image); }
+
+    for (int i = 0; i < count; i++)
+    {
+        const AtlasRegion& region = atlas.get_region(atlas_index[i]);
+        sprites[i].page_texture_id = page_texture_ids[region.page];
+        sprites[i].uv_rect = region.uv_rect;
+    }
+
+    LOG(count << " sprites packed into " << atlas.get_page_count() << " atlas page(s)");
+}
+
 void initialise()
 {
+    Uint64 start_counter = SDL_GetPerformanceCounter();
+    g_launch_counter = start_counter;
+
+#ifndef __APPLE__
+    // No display needed; an SDL_VIDEODRIVER already in the environment wins
+    if (g_offscreen) { SDL_setenv("SDL_VIDEODRIVER", "offscreen", 0); }
+#endif
+
     SDL_Init(SDL_INIT_VIDEO);
     g_display_window = SDL_CreateWindow("Lunar Lander",
                                         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
                                         WINDOW_WIDTH, WINDOW_HEIGHT,
-                                        SDL_WINDOW_OPENGL);
+                                        SDL_WINDOW_OPENGL | (g_offscreen ? SDL_WINDOW_HIDDEN : 0));
 
     SDL_GLContext context = SDL_GL_CreateContext(g_display_window);
     SDL_GL_MakeCurrent(g_display_window, context);
@@ -137,72 +309,130 @@ void initialise()
 
     glViewport(VIEWPORT_X, VIEWPORT_Y, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
 
+    Uint64 shader_counter = SDL_GetPerformanceCounter();
+    ShaderProgram::set_binary_cache_directory(g_shader_cache_directory != nullptr ? g_shader_cache_directory : "");
     g_shader_program.load(V_SHADER_PATH, F_SHADER_PATH);
+    g_instanced_program.load(V_INSTANCED_SHADER_PATH, F_SHADER_PATH);
+    double shader_seconds = (double) (SDL_GetPerformanceCounter() - shader_counter) / SDL_GetPerformanceFrequency();
+    int cached_programs = g_shader_program.is_from_binary_cache() + g_instanced_program.is_from_binary_cache();
 
     g_view_matrix = glm::mat4(1.0f);
     g_projection_matrix = glm::ortho(-5.0f, 5.0f, -3.75f, 3.75f, -1.0f, 1.0f);
 
     g_shader_program.set_projection_matrix(g_projection_matrix);
     g_shader_program.set_view_matrix(g_view_matrix);
+    g_instanced_program.set_projection_matrix(g_projection_matrix);
+    g_instanced_program.set_view_matrix(g_view_matrix);
 
-    glUseProgram(g_shader_program.get_program_id());
+    GLStateCache::get().use_program(g_shader_program.get_program_id());
 
     glClearColor(BG_RED, BG_BLUE, BG_GREEN, BG_OPACITY);
         
-    g_game_state.platforms = new Entity[PLATFORM_COUNT];
-    GLuint platform_texture_id = load_texture(PLATFORM_FILEPATH);
-    GLuint target_texture_id = load_texture(TARGET_FILEPATH);
-    int random_int = rand() % PLATFORM_COUNT;
+    const char* const texture_filepaths[] = { PLATFORM_FILEPATH, TARGET_FILEPATH, SPRITESHEET_FILEPATH,
+                                              GAME_FAIL_FILEPATH, GAME_WON_FILEPATH };
+    constexpr int TEXTURE_COUNT = sizeof(texture_filepaths) / sizeof(texture_filepaths[0]);
+    AtlasSprite sprites[TEXTURE_COUNT];
+
+    Uint64 texture_counter = SDL_GetPerformanceCounter();
+    if (!g_texture_pack.open(TEXTURE_PACK_FILEPATH)) { LOG("No texture pack; decoding PNGs"); }
+    load_sprites(texture_filepaths, sprites, TEXTURE_COUNT);
+    double texture_seconds = (double) (SDL_GetPerformanceCounter() - texture_counter) / SDL_GetPerformanceFrequency();
+
+    AtlasSprite platform_sprite  = sprites[0],
+                target_sprite    = sprites[1],
+                player_sprite    = sprites[2],
+                game_fail_sprite = sprites[3],
+                game_won_sprite  = sprites[4];
+
+    // The level comes from a seed rather than rand(), so a recording can lay it out again
+    if (g_replay_path != nullptr && !load_input_recording(g_replay_path, g_recording))
+    {
+        LOG("Unable to load replay " << g_replay_path << "; playing live");
+        g_replay_path = nullptr;
+    }
+
+    if (g_replay_path == nullptr)
+    {
+        g_recording = InputRecording();
+        g_recording.seed = g_offscreen ? OFFSCREEN_SEED : (unsigned long long) time(nullptr) ^ SDL_GetPerformanceCounter();
+        g_recording.delta_time = FIXED_TIMESTEP;
+    }
+    else if (g_recording.delta_time != FIXED_TIMESTEP)
+    {
+        LOG("Replay was recorded at a " << g_recording.delta_time << " s step; it will not reproduce at " << FIXED_TIMESTEP);
+    }
+
+    seed_game_state(g_game_state, g_recording.seed);
+
     for (int i = 0; i < PLATFORM_COUNT; i++)
     {
-        g_game_state.platforms[i] = Entity();
-        g_game_state.platforms[i].set_texture_id(platform_texture_id);
-        g_game_state.platforms[i].set_position(glm::vec3(i - PLATFORM_COUNT / 2.0f, -3.0f, 0.0f));
-
-        if (i == random_int) {
-            g_game_state.platforms[i].set_texture_id(target_texture_id);
-            g_game_state.platforms[i].set_position(glm::vec3(i - PLATFORM_COUNT / 2.0f, -3.0f, 0.0f));
-            g_game_state.platforms[i].set_platform_type(TRAP);
-        }
-        else {
-            g_game_state.platforms[i].set_platform_type(NORMAL);
+        g_game_state.platforms[i].set_sprite(
+            g_game_state.platforms[i].get_platform_type() == TRAP ? target_sprite : platform_sprite);
+    }
+    g_game_state.player.set_sprite(player_sprite);
+    snapshot_game_state(g_game_state, g_level_start);
+
+    // Tiles first so the platforms, added after them on the same page, draw on top
+    if (g_tile_field_count > 0)
+    {
+        int side = (int) ceil(sqrt((double) g_tile_field_count));
+        float tile_width = 10.0f / side, tile_height = 7.5f / side;
+        for (int i = 0; i < g_tile_field_count; i++)
+        {
+            g_static_quads.add(platform_sprite, -5.0f + (i % side + 0.5f) * tile_width, -3.75f + (i / side + 0.5f) * tile_height,
+                               tile_width * 0.5f, tile_height * 0.5f);
         }
+    }
+    g_game_state.platforms.add_instances(&g_static_quads);
+    g_static_quads.upload();
 
-        g_game_state.platforms[i].update(0.0f, NULL, 0);
+    // Streamed through SpriteBatch every frame like the lander, unlike the platforms
+    Rng bench_rng(OFFSCREEN_SEED);
+    for (int i = 0; i < g_bench_render_count; i++)
+    {
+        Entity lander;
+        lander.set_sprite(player_sprite);
+        lander.set_position(glm::vec3(bench_rng.next_float(-5.0f, 5.0f), bench_rng.next_float(-3.75f, 3.75f), 0.0f));
+        lander.update(0.0f, nullptr, nullptr);   // builds the model matrix
+        g_bench_entities.push_back(lander);
     }
     
-    GLuint player_texture_id = load_texture(SPRITESHEET_FILEPATH);
-    
-    g_game_state.player = new Entity();
-    g_game_state.player->set_position(glm::vec3(0.0f, 2.0f, 0.0f));
-    g_game_state.player->set_movement(glm::vec3(0.0f));
-    g_game_state.player->set_acceleration(glm::vec3(0.0f, g_gravity * 0.1, 0.0f));
-    g_game_state.player->set_speed(1.0f);
-    g_game_state.player->set_texture_id(player_texture_id);
-    g_game_state.player->set_height(0.9f);
-    g_game_state.player->set_width(0.9f);
-    g_game_state.player->set_collisioin_type(NOCOLLISION);
-    
-    GLuint game_fail_texture_id = load_texture(GAME_FAIL_FILEPATH);
-    g_game_state.game_lost = new Entity();
-    g_game_state.game_lost->set_position(glm::vec3(0.0f));
-    g_game_state.game_lost->set_texture_id(game_fail_texture_id);
-    g_game_state.game_lost->scale(glm::vec3(3.58f, 1.79f, 0.0f));
+    g_game_lost = new Entity();
+    g_game_lost->set_position(glm::vec3(0.0f));
+    g_game_lost->set_sprite(game_fail_sprite);
+    g_game_lost->scale(glm::vec3(3.58f, 1.79f, 0.0f));
     
-    GLuint game_won_texture_id = load_texture(GAME_WON_FILEPATH);
-    g_game_state.game_won = new Entity();
-    g_game_state.game_won->set_position(glm::vec3(0.0f));
-    g_game_state.game_won->set_texture_id(game_won_texture_id);
-    g_game_state.game_won->scale(glm::vec3(3.55f, 2.0f, 0.0f));
+    g_game_won = new Entity();
+    g_game_won->set_position(glm::vec3(0.0f));
+    g_game_won->set_sprite(game_won_sprite);
+    g_game_won->scale(glm::vec3(3.55f, 2.0f, 0.0f));
     
     // ––––– GENERAL ––––– //
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    g_previous_counter = SDL_GetPerformanceCounter();
+
+    double startup_seconds = (double) (g_previous_counter - start_counter) / SDL_GetPerformanceFrequency();
+    LOG("cold start: " << startup_seconds * 1e3 << " ms (textures: " << texture_seconds * 1e3 << " ms, shaders: "
+        << shader_seconds * 1e3 << " ms with " << cached_programs << " of 2 programs from the binary cache)");
+}
+
+void restart()
+{
+    Uint64 start_counter = SDL_GetPerformanceCounter();
+
+    restore_game_state(g_game_state, g_level_start);
+    g_rewind.clear();
+    g_recording.inputs.clear();   // same seed, so the recording simply starts over
+
+    double microseconds = (double) (SDL_GetPerformanceCounter() - start_counter) * 1e6 / SDL_GetPerformanceFrequency();
+    LOG("restart: " << microseconds << " us");
 }
 
 void process_input()
 {
-    g_game_state.player->set_movement(glm::vec3(0.0f));
+    PROFILE_ZONE("process_input");
 
     SDL_Event event;
     while (SDL_PollEvent(&event))
@@ -214,6 +444,10 @@ void process_input()
             g_game_is_running = false;
             break;
 
+        case SDL_WINDOWEVENT:
+            g_redraw_requested = true;
+            break;
+
         case SDL_KEYDOWN:
             switch (event.key.keysym.sym) {
             case SDLK_q:
@@ -221,10 +455,19 @@ void process_input()
                 g_game_is_running = false;
                 break;
 
+            case SDLK_r:
+                // Restart the level without touching shaders or textures; the simulation thread does it
+                if (g_replay_path == nullptr) { g_restart_requested = true; }
+                break;
+
+            case SDLK_p:
+                g_paused = !g_paused;
+                break;
+
             //case SDLK_SPACE:
             //    // Jump
-            //        if (g_game_state.player->get_collided_bottom()) {
-            //            g_game_state.player->jump();
+            //        if (g_game_state.player.get_collided_bottom()) {
+            //            g_game_state.player.jump();
             //        }
             //    break;
 
@@ -239,124 +482,402 @@ void process_input()
 
     const Uint8* key_state = SDL_GetKeyboardState(NULL);
 
-    if (!g_game_over) {
+    g_rewinding = key_state[SDL_SCANCODE_BACKSPACE] && g_replay_path == nullptr;
+
+    unsigned char input = 0;
+    if (key_state[SDL_SCANCODE_LEFT])  { input |= INPUT_LEFT;  }
+    if (key_state[SDL_SCANCODE_RIGHT]) { input |= INPUT_RIGHT; }
+    if (key_state[SDL_SCANCODE_UP])    { input |= INPUT_UP;    }
+    if (key_state[SDL_SCANCODE_DOWN])  { input |= INPUT_DOWN;  }
+    g_frame_input = input;
+}
+
+void update()
+{
+    PROFILE_ZONE("update");
+    Uint64 counter = SDL_GetPerformanceCounter(); // high-resolution clock, no float-seconds rounding
+    float delta_time = (float) ((double) (counter - g_previous_counter) / SDL_GetPerformanceFrequency());
+    g_previous_counter = counter;
+
+    g_game_state.time_accumulator += delta_time;
 
-        if (key_state[SDL_SCANCODE_LEFT])
+    int steps = 0;
+    while (g_game_state.time_accumulator >= FIXED_TIMESTEP && steps < MAX_STEPS_PER_FRAME)
+    {
+        PROFILE_ZONE("fixed_step");
+
+        // Rewinding replaces the step with the previous step's snapshot, one per step
+        if (g_rewinding)
         {
-            g_game_state.player->set_acceleration(glm::vec3(-1.0f, 0.0f, 0.0f));
+            SimState snapshot;
+            if (g_rewind.pop(snapshot))
+            {
+                float time_accumulator = g_game_state.time_accumulator;
+                restore_game_state(g_game_state, snapshot);
+                g_game_state.time_accumulator = time_accumulator;
+
+                // Steps undone here are no longer part of the session
+                g_recording.inputs.resize(g_game_state.step);
+            }
+
+            g_game_state.time_accumulator -= FIXED_TIMESTEP;
+            steps++;
+            continue;
         }
-        else if (key_state[SDL_SCANCODE_RIGHT])
+
+        g_rewind.push(g_game_state);
+
+        // Input is consumed per fixed step, not per frame, so a replay lines up step for step
+        unsigned char input = g_frame_input;
+        if (g_replay_path != nullptr)
         {
-            g_game_state.player->set_acceleration(glm::vec3(1.0f, 0.0f, 0.0f));
+            input = g_replay_step < g_recording.inputs.size() ? g_recording.inputs[g_replay_step] : 0;
+            g_replay_step++;
         }
         else
         {
-            g_game_state.player->set_acceleration(glm::vec3(0.0f, g_gravity * 0.1, 0.0f));
+            g_recording.inputs.push_back(input);
         }
+
+        apply_input(g_game_state, input);
+        step_game_state(g_game_state, FIXED_TIMESTEP);
         
-        if (key_state[SDL_SCANCODE_UP])
+        g_game_state.time_accumulator -= FIXED_TIMESTEP;
+        steps++;
+    }
+
+    // Out of catch-up budget: keep the sub-step phase, drop the whole steps
+    if (g_game_state.time_accumulator >= FIXED_TIMESTEP)
+    {
+        g_game_state.time_accumulator = fmodf(g_game_state.time_accumulator, FIXED_TIMESTEP);
+    }
+}
+
+void publish_snapshot()
+{
+    RenderSnapshot& snapshot = g_snapshots.back();
+    snapshot.player = g_game_state.player;
+    snapshot.game_over = g_game_state.game_over;
+    snapshot.game_win = g_game_state.game_win;
+    snapshot.time_accumulator = g_game_state.time_accumulator;
+    snapshot.counter = SDL_GetPerformanceCounter();
+    g_snapshots.publish();
+}
+
+// Simulation thread: fixed steps on its own clock, so a blocking swap on the
+// render thread no longer holds them back
+void simulate()
+{
+    profiler_set_thread_name("simulation");
+
+    // What a frame of the lander shows; steps after a touchdown change none of it
+    glm::vec3 published_position = g_game_state.player.get_position();
+    glm::vec3 published_previous_position = g_game_state.player.get_previous_position();
+    bool published_game_over = g_game_state.game_over;
+
+    while (g_game_is_running)
+    {
+        if (g_restart_requested.exchange(false)) { restart(); }
+
+        if (g_paused)
         {
-            g_game_state.player->set_acceleration(glm::vec3(0.0f, 1.0f + g_gravity * 0.1, 0.0f));
+            // Keep the clock moving, or unpausing would replay the pause as catch-up steps
+            g_previous_counter = SDL_GetPerformanceCounter();
+            std::this_thread::sleep_for(std::chrono::duration<float>(FIXED_TIMESTEP));
+            continue;
         }
-        else if (key_state[SDL_SCANCODE_DOWN])
+
+        update();
+
+        // Publishing only what changed lets an on-demand render loop go idle on the game-over screen
+        if (g_game_state.player.get_position() != published_position ||
+            g_game_state.player.get_previous_position() != published_previous_position ||
+            g_game_state.game_over != published_game_over)
         {
-            g_game_state.player->set_acceleration(glm::vec3(0.0f, -1.0f - g_gravity * 0.1, 0.0f));
+            publish_snapshot();
+            published_position = g_game_state.player.get_position();
+            published_previous_position = g_game_state.player.get_previous_position();
+            published_game_over = g_game_state.game_over;
         }
 
-        if (glm::length(g_game_state.player->get_movement()) > 1.0f)
+        // Sleep until the next step is due
+        float until_next_step = FIXED_TIMESTEP - g_game_state.time_accumulator;
+        if (until_next_step > 0.0f)
         {
-            g_game_state.player->set_movement(glm::normalize(g_game_state.player->get_movement()));
+            std::this_thread::sleep_for(std::chrono::duration<float>(until_next_step));
         }
     }
 }
 
-void update()
+void render()
 {
-    float ticks = (float)SDL_GetTicks() / MILLISECONDS_IN_SECOND; // get the current number of ticks
-    float delta_time = ticks - g_previous_ticks; // the delta time is the difference from the last frame
-    g_previous_ticks = ticks;
+    PROFILE_ZONE("render");
+    glClear(GL_COLOR_BUFFER_BIT);
 
-    delta_time += g_time_accumulator;
+    // Always the newest published step; older ones the render thread was too slow for are skipped
+    const RenderSnapshot& snapshot = g_snapshots.acquire();
 
-    if (delta_time < FIXED_TIMESTEP)
-    {
-        g_time_accumulator = delta_time;
-        return;
-    }
+    // How far we are between the last two physics steps, counting the time since it was published.
+    // Offscreen frames show whole steps so that they are reproducible.
+    double since_publish = (double) (SDL_GetPerformanceCounter() - snapshot.counter) / SDL_GetPerformanceFrequency();
+    float alpha = g_offscreen ? 1.0f : std::min((snapshot.time_accumulator + (float) since_publish) / FIXED_TIMESTEP, 1.0f);
+
+    GLStateCache::get().reset_counters();
+    g_sprite_batch.begin(&g_shader_program);
 
-    while (delta_time >= FIXED_TIMESTEP)
+    g_static_quads.draw(&g_instanced_program);
+
+    for (const Entity& lander : g_bench_entities) { lander.render(&g_sprite_batch); }
+
+    snapshot.player.render(&g_sprite_batch, alpha);
+
+    if (snapshot.game_over)
     {
-        CollisionType result = g_game_state.player->check_collision_y(g_game_state.platforms, PLATFORM_COUNT);
-        //g_game_state.player->update(FIXED_TIMESTEP, g_game_state.platforms, PLATFORM_COUNT);
-        
-        if (!g_game_over) {
-            result = g_game_state.player->update(FIXED_TIMESTEP, g_game_state.platforms, PLATFORM_COUNT);
-        }
-        
-        if (result == GROUND) {
-            g_game_over = true;
-            g_game_win = false;
-            g_game_state.player->set_movement(glm::vec3(0.0f));
-            g_game_state.player->deactivate();
-        
-            g_game_state.game_lost->render(&g_shader_program);
+        // Submitted last, so it lands on top: quads on one atlas page keep submission order
+        if (snapshot.game_win)
+        {
+            g_game_won->render(&g_sprite_batch);
         }
-        else if (result == HITTARGET) {
-            g_game_over = true;
-            g_game_win = true;
-            g_game_state.player->set_movement(glm::vec3(0.0f));
-            g_game_state.player->deactivate();
-        
-            g_game_state.game_won->render(&g_shader_program);
+        else
+        {
+            g_game_lost->render(&g_sprite_batch);
         }
-        
-        delta_time -= FIXED_TIMESTEP;
+    }
+
+    g_sprite_batch.end();
+
+    int draw_calls = g_static_quads.get_draw_call_count() + g_sprite_batch.get_draw_call_count();
+    if (draw_calls != g_last_draw_calls)
+    {
+        g_last_draw_calls = draw_calls;
+        LOG("draw calls / frame: " << g_last_draw_calls << " (" << g_static_quads.get_instance_count() << " instanced at "
+            << g_static_quads.get_bytes_per_sprite() << " bytes each, uploaded once; "
+            << g_sprite_batch.get_sprite_count() << " batched), "
+            << "GL state calls issued: " << GLStateCache::get().get_issued_count()
+            << ", skipped: " << GLStateCache::get().get_skipped_count());
     }
     
-    g_time_accumulator = delta_time;
+    if (!g_offscreen)
+    {
+        PROFILE_ZONE("SDL_GL_SwapWindow");
+        SDL_GL_SwapWindow(g_display_window);
+    }
+
+    if (!g_first_frame_reported)
+    {
+        // Wait for the GPU as well: drivers defer part of shader compilation to the first draw
+        glFinish();
+        g_first_frame_reported = true;
+
+        double seconds = (double) (SDL_GetPerformanceCounter() - g_launch_counter) / SDL_GetPerformanceFrequency();
+        LOG("time to first frame: " << seconds * 1e3 << " ms (shader binary cache "
+            << (g_shader_cache_directory != nullptr ? "on" : "off") << ")");
+    }
+
 }
 
-void render()
+void log_frame_stats()
 {
-    glClear(GL_COLOR_BUFFER_BIT);
+    uint64_t now = pacer_now_ns();
+    double seconds = (now - g_frame_stats_start_ns) * 1e-9;
+    if (seconds < FRAME_STATS_INTERVAL_SECONDS) { return; }
+
+    FramePacerStats stats = g_frame_pacer.get_stats();
+    LOG("frames: " << stats.frames / seconds << "/s (" << g_rendered_frames / seconds << " rendered), "
+        << "cpu " << stats.average_cpu_ms << " ms/frame, busy " << stats.average_busy_ms << " ms/frame, "
+        << "latest wake " << stats.max_late_ms << " ms late");
+
+    g_frame_pacer.reset_stats();
+    g_rendered_frames = 0;
+    g_frame_stats_start_ns = now;
+}
 
-    g_game_state.player->render(&g_shader_program);
-    
-    for (int i = 0; i < PLATFORM_COUNT; i++)
+// One fixed step off the wall clock: the replay's input if there is one, otherwise none
+void step_offscreen()
+{
+    unsigned char input = g_replay_step < g_recording.inputs.size() ? g_recording.inputs[g_replay_step] : 0;
+    g_replay_step++;
+
+    apply_input(g_game_state, input);
+    step_game_state(g_game_state, FIXED_TIMESTEP);
+}
+
+int check_golden_frame()
+{
+    for (int i = 0; i < g_golden_steps; i++) { step_offscreen(); }
+    publish_snapshot();
+    render();
+
+    std::vector<unsigned char> frame;
+    g_offscreen_target.read_pixels(frame);
+    int width = g_offscreen_target.get_width(), height = g_offscreen_target.get_height();
+
+    if (g_update_golden)
+    {
+        if (!write_png(g_golden_path, frame.data(), width, height)) { LOG("Unable to write " << g_golden_path); return 1; }
+        LOG("Wrote golden frame (step " << g_golden_steps << ") to " << g_golden_path);
+        return 0;
+    }
+
+    DecodedImage golden;
+    if (!decode_image_file(g_golden_path, golden))
     {
-        g_game_state.platforms[i].render(&g_shader_program);
+        LOG("No golden frame at " << g_golden_path << "; create it with --update-golden");
+        return 1;
     }
 
-    if (g_game_over)
+    ImageDifference difference;
+    bool same_size = golden.width == width && golden.height == height;
+    if (same_size) { difference = compare_images(frame.data(), golden.pixels, width, height, GOLDEN_TOLERANCE); }
+    free_decoded_image(golden);
+
+    if (same_size && difference.differing_pixels == 0)
     {
-        if (g_game_win)
+        LOG("Golden frame matches " << g_golden_path << " (max channel difference " << difference.max_channel_difference << ")");
+        return 0;
+    }
+
+    // Keep what was rendered next to the golden for inspection
+    std::string actual_path = std::string(g_golden_path) + ".actual.png";
+    write_png(actual_path.c_str(), frame.data(), width, height);
+
+    if (!same_size) { LOG("Golden frame is " << golden.width << "x" << golden.height << ", rendered " << width << "x" << height); }
+    else
+    {
+        LOG("Golden frame mismatch: " << difference.differing_pixels << " pixels off by more than " << GOLDEN_TOLERANCE
+            << " (max " << difference.max_channel_difference << ")");
+    }
+    LOG("Rendered frame written to " << actual_path);
+    return 1;
+}
+
+void run_render_benchmark()
+{
+    publish_snapshot();
+
+    for (int i = 0; i < BENCH_RENDER_WARMUP_FRAMES; i++) { render(); }
+    glFinish();
+
+    Uint64 start_counter = SDL_GetPerformanceCounter();
+    for (int i = 0; i < BENCH_RENDER_FRAMES; i++) { render(); }
+    glFinish();   // count the frames the GPU still had queued
+    double seconds = (double) (SDL_GetPerformanceCounter() - start_counter) / SDL_GetPerformanceFrequency();
+
+    LOG("render(): " << g_bench_render_count << " landers + " << g_static_quads.get_instance_count() << " instanced, "
+        << BENCH_RENDER_FRAMES / seconds << " frames/s (" << seconds * 1e3 / BENCH_RENDER_FRAMES << " ms/frame, "
+        << g_last_draw_calls << " draw calls) on " << glGetString(GL_RENDERER));
+}
+
+int run_offscreen()
+{
+    if (!g_offscreen_target.create(WINDOW_WIDTH, WINDOW_HEIGHT))
+    {
+        LOG("ERROR: Could not create an offscreen framebuffer.");
+        return 1;
+    }
+    g_offscreen_target.bind();
+
+    int status = 0;
+    if (g_golden_path != nullptr)     { status = check_golden_frame(); }
+    if (g_bench_render_count >= 0)    { run_render_benchmark(); }
+    return status;
+}
+
+void shutdown()
+{
+    if (g_record_path != nullptr && g_replay_path == nullptr)
+    {
+        if (save_input_recording(g_recording, g_record_path))
         {
-            g_game_state.game_won->render(&g_shader_program);
+            LOG("Recorded " << g_recording.inputs.size() << " steps (seed " << g_recording.seed << ") to " << g_record_path);
         }
         else
         {
-            g_game_state.game_lost->render(&g_shader_program);
+            LOG("Unable to write recording to " << g_record_path);
         }
-        //g_game_state.game_lost->render(&g_shader_program);
     }
-    
-    SDL_GL_SwapWindow(g_display_window);
 
-}
+    if (g_replay_path != nullptr)
+    {
+        glm::vec3 position = g_game_state.player.get_position();
+        LOG("Replay ended after " << g_replay_step << " steps at (" << position.x << ", " << position.y << ")");
+    }
 
-void shutdown() { SDL_Quit(); }
+    if (g_trace_path != nullptr)
+    {
+        if (profiler_write_chrome_trace(g_trace_path, g_trace_frames)) { LOG("Wrote trace to " << g_trace_path); }
+        else                                                           { LOG("Unable to write trace to " << g_trace_path); }
+    }
+
+    // GL objects go while the context is still current; global destructors run after SDL_Quit
+    g_sprite_batch.release();
+    g_static_quads.release();
+    g_offscreen_target.release();
+
+    g_texture_pack.close();
+    SDL_Quit();
+}
 
 int main(int argc, char* argv[])
 {
+    // --trace FILE [--trace-frames N]: dump the last N frames as Chrome trace JSON on exit
+    for (int i = 1; i < argc; i++)
+    {
+        if      (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)        { g_trace_path = argv[++i]; }
+        else if (strcmp(argv[i], "--trace-frames") == 0 && i + 1 < argc) { g_trace_frames = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)       { g_record_path = argv[++i]; }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)       { g_replay_path = argv[++i]; }
+        else if (strcmp(argv[i], "--tile-field") == 0 && i + 1 < argc)   { g_tile_field_count = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)          { g_frame_pacer.set_target_fps((float) atof(argv[++i])); }
+        else if (strcmp(argv[i], "--on-demand") == 0)                    { g_on_demand = true; }
+        else if (strcmp(argv[i], "--shader-cache") == 0 && i + 1 < argc) { g_shader_cache_directory = argv[++i]; }
+        else if (strcmp(argv[i], "--no-shader-cache") == 0)              { g_shader_cache_directory = nullptr; }
+        else if (strcmp(argv[i], "--offscreen") == 0)                    { g_offscreen = true; }
+        else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc)       { g_golden_path = argv[++i]; g_offscreen = true; }
+        else if (strcmp(argv[i], "--update-golden") == 0)                { g_update_golden = true; }
+        else if (strcmp(argv[i], "--golden-steps") == 0 && i + 1 < argc) { g_golden_steps = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--bench-render") == 0 && i + 1 < argc) { g_bench_render_count = std::max(atoi(argv[++i]), 0); g_offscreen = true; }
+    }
+
+    if (g_trace_path != nullptr)
+    {
+        profiler_set_enabled(true);
+        profiler_set_thread_name("main");
+    }
+
     initialise();
 
+    if (g_offscreen)
+    {
+        int status = run_offscreen();
+        shutdown();
+        return status;
+    }
+
+    // The render thread needs something to draw before the first step lands
+    publish_snapshot();
+    g_sim_thread = std::thread(simulate);
+
+    g_frame_stats_start_ns = pacer_now_ns();
+
     while (g_game_is_running)
     {
+        profiler_mark_frame();
+
         process_input();
-        update();
-        render();
+
+        if (!g_on_demand || g_redraw_requested || g_snapshots.has_fresh())
+        {
+            render();
+            g_redraw_requested = false;
+            g_rendered_frames++;
+        }
+
+        g_frame_pacer.wait();
+        log_frame_stats();
     }
 
+    g_sim_thread.join();
     shutdown();
     return 0;
 }
@@ -0,0 +1,20 @@
+attribute vec4 position;
+attribute vec2 texCoord;
+
+// Per instance: centre and size, then the sprite's rect on its atlas page
+attribute vec4 instanceTransform;
+attribute vec4 instanceUv;
+
+uniform mat4 modelMatrix;
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+
+varying vec2 texCoordVar;
+
+void main()
+{
+    vec4 world = vec4(instanceTransform.xy + position.xy * instanceTransform.zw, 0.0, 1.0);
+	vec4 p = viewMatrix * modelMatrix * world;
+    texCoordVar = mix(instanceUv.xy, instanceUv.zw, texCoord);
+	gl_Position = projectionMatrix * p;
+}